@@ -23,6 +23,8 @@ SOFTWARE. */
 
 #include "FileDownloader.h"
 
+#include <common/functions.h>
+
 #include <QDebug>
 #include <QFileInfo>
 #include <QNetworkReply>
@@ -35,16 +37,6 @@ SOFTWARE. */
 #define DEBUG(f) ((void)0)
 #endif
 
-namespace
-{
-
-bool isURLLocalFile(QString url)
-{
-  return !url.startsWith("https://") && !url.startsWith("http://");
-}
-
-} // namespace
-
 FileDownloader::FileDownloader(ILogger *logger) : logger(logger)
 {
   DEBUG("FileDownloader - Built with SSL version: " << QSslSocket::sslLibraryBuildVersionString());
@@ -92,11 +84,14 @@ void FileDownloader::replyFinished(QNetworkReply *reply)
   else
   {
     this->currentSegment->compressedData      = reply->readAll();
+    this->currentSegment->isLocalFile         = false;
     this->currentSegment->downloadProgress    = 100.0;
     this->currentSegment->downloadFinished    = true;
     this->currentSegment->compressedSizeBytes = this->currentSegment->compressedData.size();
-    this->currentSegment                      = nullptr;
-    emit downloadOfSegmentFinished();
+    this->addCurrentDownloadToStatistics();
+    auto finishedSegment = this->currentSegment;
+    this->currentSegment = nullptr;
+    emit downloadOfSegmentFinished(finishedSegment);
   }
 
   this->state = State::Idle;
@@ -109,10 +104,12 @@ void FileDownloader::updateDownloadProgress(int64_t val, int64_t max)
   if (max > 0 && val > 0)
   {
     auto downloadPercent = val * 100 / max;
-    if (this->currentSegment)
+    if (this->currentSegment &&
+        this->currentSegment->downloadProgress != Segment::Percent(downloadPercent))
     {
       this->currentSegment->downloadProgress    = Segment::Percent(downloadPercent);
       this->currentSegment->compressedSizeBytes = size_t(max);
+      emit downloadProgressChanged();
     }
   }
 }
@@ -137,6 +134,7 @@ void FileDownloader::tryStartOfNextDownload()
 
   this->currentSegment = this->downloadQueue.front();
   this->downloadQueue.pop();
+  this->downloadStartTime = std::chrono::steady_clock::now();
 
   auto url = this->currentSegment->segmentInfo.downloadUrl;
   if (isURLLocalFile(url))
@@ -149,10 +147,12 @@ void FileDownloader::tryStartOfNextDownload()
       // For local files the download finishes immediately
       DEBUG("Loading local file " << url);
       this->currentSegment->compressedData      = inputFile.readAll();
+      this->currentSegment->isLocalFile         = true;
       this->currentSegment->downloadProgress    = 100.0;
       this->currentSegment->downloadFinished    = true;
       this->currentSegment->compressedSizeBytes = this->currentSegment->compressedData.size();
-      emit downloadOfSegmentFinished();
+      this->addCurrentDownloadToStatistics();
+      emit downloadOfSegmentFinished(this->currentSegment);
       this->tryStartOfNextDownload();
     }
   }
@@ -166,3 +166,12 @@ void FileDownloader::tryStartOfNextDownload()
     this->state = State::Downloading;
   }
 }
+
+void FileDownloader::addCurrentDownloadToStatistics()
+{
+  auto duration = std::chrono::steady_clock::now() - this->downloadStartTime;
+  this->statistics.nrSegments++;
+  this->statistics.nrBytes += this->currentSegment->compressedSizeBytes;
+  this->statistics.durationUs +=
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
@@ -29,6 +29,7 @@ SOFTWARE. */
 
 #include <QDir>
 #include <QNetworkAccessManager>
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -51,15 +52,22 @@ public:
   QString getStatus() const;
   size_t  getQueueSize() const;
 
-  struct DownloadInfo
+  // Counted over all finished downloads. Only accessed from the thread of the downloader.
+  struct Statistics
   {
+    unsigned    nrSegments{};
+    std::size_t nrBytes{};
+    int64_t     durationUs{};
   };
+  Statistics getStatistics() const { return this->statistics; }
 
 public slots:
   void addFileToDownloadQueue(Segment *segment);
 
 signals:
-  void downloadOfSegmentFinished();
+  void downloadOfSegmentFinished(Segment *segment);
+  // Emitted whenever the download progress of the current segment advanced by at least a percent
+  void downloadProgressChanged();
 
 private slots:
   void replyFinished(QNetworkReply *reply);
@@ -83,4 +91,8 @@ private:
 
   std::queue<Segment *> downloadQueue;
   void                  tryStartOfNextDownload();
+
+  Statistics                            statistics;
+  std::chrono::steady_clock::time_point downloadStartTime;
+  void                                  addCurrentDownloadToStatistics();
 };
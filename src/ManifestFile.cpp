@@ -27,6 +27,7 @@ SOFTWARE. */
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <algorithm>
 
 namespace
 {
@@ -197,6 +198,69 @@ bool ManifestFile::openFromData(QByteArray data)
     if (mainObject.contains("MaxSegmentBufferSize"))
       this->maxSegmentBufferSize = size_t(mainObject["MaxSegmentBufferSize"].toInt());
 
+    if (mainObject.contains("MemoryBudgetMB"))
+      this->memoryBudgetMB = size_t(std::max(mainObject["MemoryBudgetMB"].toInt(), 0));
+
+    if (mainObject.contains("Decoder"))
+    {
+      if (!mainObject["Decoder"].isObject())
+        throw std::logic_error("Decoder is not an object");
+      auto decoderObject = mainObject["Decoder"].toObject();
+
+      if (decoderObject.contains("Engine"))
+      {
+        auto engine = decoderObject["Engine"].toString().toLower().toStdString();
+        this->decoderSettings.engine = decoder::DecoderEngineMapper.getValue(engine);
+        if (!this->decoderSettings.engine)
+          throw std::logic_error("Decoder Engine value unknown");
+      }
+      if (decoderObject.contains("Synthetic"))
+      {
+        if (!decoderObject["Synthetic"].isObject())
+          throw std::logic_error("Decoder Synthetic is not an object");
+        auto  syntheticObject = decoderObject["Synthetic"].toObject();
+        auto &synthetic       = this->decoderSettings.synthetic;
+
+        if (syntheticObject.contains("Width") || syntheticObject.contains("Height"))
+          synthetic.frameSize =
+              Size(syntheticObject["Width"].toInt(), syntheticObject["Height"].toInt());
+        if (syntheticObject.contains("Subsampling"))
+        {
+          auto subsampling = syntheticObject["Subsampling"].toString().toStdString();
+          synthetic.subsampling = video::yuv::SubsamplingMapper.getValue(subsampling);
+          if (!synthetic.subsampling)
+            throw std::logic_error("Decoder Synthetic Subsampling value unknown");
+        }
+        if (syntheticObject.contains("BitDepth"))
+          synthetic.bitDepth = syntheticObject["BitDepth"].toInt();
+        if (syntheticObject.contains("FrameLatencyUs"))
+          synthetic.frameLatencyUs = syntheticObject["FrameLatencyUs"].toInt();
+      }
+      if (decoderObject.contains("Threads"))
+        this->decoderSettings.threads = decoderObject["Threads"].toInt();
+      if (decoderObject.contains("ParseThreads"))
+        this->decoderSettings.parseThreads = decoderObject["ParseThreads"].toInt();
+      if (decoderObject.contains("SIMD"))
+      {
+        auto simd = decoderObject["SIMD"].toString().toLower().toStdString();
+        this->decoderSettings.simd = decoder::SIMDExtensionMapper.getValue(simd);
+        if (!this->decoderSettings.simd)
+          throw std::logic_error("Decoder SIMD value unknown");
+      }
+      if (decoderObject.contains("Upscaling"))
+      {
+        auto upscaling = decoderObject["Upscaling"].toString().toLower().toStdString();
+        this->decoderSettings.upscaling = decoder::UpscalingModeMapper.getValue(upscaling);
+        if (!this->decoderSettings.upscaling)
+          throw std::logic_error("Decoder Upscaling value unknown");
+      }
+      if (decoderObject.contains("Instances"))
+        this->decoderSettings.instances = decoderObject["Instances"].toInt();
+      if (decoderObject.contains("SkipNonReferenceThreshold"))
+        this->decoderSettings.skipNonReferenceThreshold =
+            decoderObject["SkipNonReferenceThreshold"].toInt();
+    }
+
     for (auto renditionValue : renditions)
     {
       if (!renditionValue.isObject())
@@ -278,3 +342,8 @@ Segment::SegmentInfo ManifestFile::getSegmentSPSHighestRendition()
   auto &rendition = this->renditions.back();
   return createSegmentInfoForRendition(rendition, 0, unsigned(this->renditions.size()) - 1);
 }
+
+Segment::SegmentInfo ManifestFile::getSegmentInfo(unsigned segmentNumber, unsigned rendition) const
+{
+  return createSegmentInfoForRendition(this->renditions.at(rendition), segmentNumber, rendition);
+}
@@ -26,6 +26,7 @@ SOFTWARE. */
 #include <common/ILogger.h>
 #include <common/Segment.h>
 #include <common/Typedef.h>
+#include <decoder/DecoderSettings.h>
 
 #include <QString>
 #include <optional>
@@ -56,9 +57,14 @@ public:
   unsigned                 getPlotMaxBitrate() const { return this->plotMaxBitrate; }
   bool   isopenGopAdaptiveResolutionChange() const { return this->openGopAdaptiveResolutionChange; }
   size_t getMaxSegmentBufferSize() const { return this->maxSegmentBufferSize; }
+  // The memory budget of the segment buffer in MB (0 for no budget)
+  size_t getMemoryBudgetMB() const { return this->memoryBudgetMB; }
+  unsigned getNumberSegments() const { return this->numberSegments; }
+  decoder::DecoderSettings getDecoderSettings() const { return this->decoderSettings; }
 
   Segment::SegmentInfo getNextSegmentInfo();
   Segment::SegmentInfo getSegmentSPSHighestRendition();
+  Segment::SegmentInfo getSegmentInfo(unsigned segmentNumber, unsigned rendition) const;
 
 private:
   ILogger *logger{};
@@ -72,6 +78,9 @@ private:
   unsigned plotMaxBitrate{};
   bool     openGopAdaptiveResolutionChange{};
   size_t   maxSegmentBufferSize{5};
+  size_t   memoryBudgetMB{};
+
+  decoder::DecoderSettings decoderSettings;
 
   std::vector<Rendition> renditions;
 
@@ -24,10 +24,20 @@ SOFTWARE. */
 #include "PlaybackController.h"
 
 #include <QDebug>
+#include <algorithm>
 #include <assert.h>
 #include <decoder/decoderVVDec.h>
 
-PlaybackController::PlaybackController(ILogger *logger) : logger(logger)
+namespace
+{
+
+constexpr std::size_t BYTES_PER_MB = 1024 * 1024;
+
+} // namespace
+
+PlaybackController::PlaybackController(ILogger *                logger,
+                                       decoder::DecoderSettings commandLineDecoderSettings)
+    : logger(logger), commandLineDecoderSettings(commandLineDecoderSettings)
 {
   assert(logger != nullptr);
   this->reset();
@@ -35,7 +45,8 @@ PlaybackController::PlaybackController(ILogger *logger) : logger(logger)
 
 PlaybackController::~PlaybackController()
 {
-  this->decoder->abort();
+  for (auto &decoder : this->decoders)
+    decoder->abort();
   this->parser->abort();
   this->conversion->abort();
   this->segmentBuffer->abort();
@@ -48,7 +59,7 @@ void PlaybackController::reset()
   this->downloader.reset(nullptr);
   this->parser.reset(nullptr);
   this->conversion.reset(nullptr);
-  this->decoder.reset(nullptr);
+  this->decoders.clear();
   this->segmentBuffer.reset(nullptr);
 
   this->logger->clearMessages();
@@ -58,12 +69,17 @@ void PlaybackController::reset()
   this->parser        = std::make_unique<FileParserThread>(this->logger, this->segmentBuffer.get());
   this->conversion =
       std::make_unique<FrameConversionThread>(this->logger, this->segmentBuffer.get());
-  this->decoder = std::make_unique<DecoderThread>(this->logger, this->segmentBuffer.get());
+  this->conversion->setConvertToRGB(this->convertFramesToRGB);
+  this->conversion->setTargetSize(this->conversionTargetSize);
 
   connect(this->downloader.get(),
           &FileDownloader::downloadOfSegmentFinished,
           this,
           &PlaybackController::downloadOfSegmentFinished);
+  connect(this->downloader.get(),
+          &FileDownloader::downloadProgressChanged,
+          this->segmentBuffer.get(),
+          &SegmentBuffer::onDownloadProgress);
   connect(this->segmentBuffer.get(),
           &SegmentBuffer::segmentRemovedFromBuffer,
           this,
@@ -77,11 +93,7 @@ bool PlaybackController::openJsonManifestFile(QString jsonManifestFile)
   this->manifestFile = std::make_unique<ManifestFile>(this->logger);
   auto success       = this->manifestFile->openJsonManifestFile(jsonManifestFile);
   if (success)
-  {
     this->activateManifest();
-    this->decoder->setOpenGopAdaptiveResolutionChange(
-        this->manifestFile->isopenGopAdaptiveResolutionChange());
-  }
   return success;
 }
 
@@ -90,11 +102,7 @@ bool PlaybackController::openPredefinedManifest(unsigned predefinedManifestID)
   this->manifestFile = std::make_unique<ManifestFile>(this->logger);
   auto success       = this->manifestFile->openPredefinedManifest(predefinedManifestID);
   if (success)
-  {
     this->activateManifest();
-    this->decoder->setOpenGopAdaptiveResolutionChange(
-        this->manifestFile->isopenGopAdaptiveResolutionChange());
-  }
   return success;
 }
 
@@ -109,18 +117,146 @@ void PlaybackController::increaseRendition() { this->manifestFile->increaseRendi
 
 void PlaybackController::decreaseRendition() { this->manifestFile->decreaseRendition(); }
 
+void PlaybackController::setConvertFramesToRGB(bool convertToRGB)
+{
+  this->convertFramesToRGB = convertToRGB;
+  if (this->conversion)
+    this->conversion->setConvertToRGB(convertToRGB);
+}
+
+void PlaybackController::setConversionTargetSize(Size targetSize)
+{
+  this->conversionTargetSize = targetSize;
+  if (this->conversion)
+    this->conversion->setTargetSize(targetSize);
+}
+
+void PlaybackController::setTrickPlaySpeed(unsigned speed)
+{
+  speed = std::clamp(speed, 1u, MAX_TRICK_PLAY_SPEED);
+  if (speed == this->trickPlaySpeed)
+    return;
+
+  this->trickPlaySpeed = speed;
+  for (auto &decoder : this->decoders)
+    decoder->setNrTemporalLayersToSkip(this->getNrTemporalLayersToSkip());
+  this->logger->addMessage(QString("Playback speed %1x").arg(speed), LoggingPriority::Info);
+}
+
+unsigned PlaybackController::getNrTemporalLayersToSkip() const
+{
+  unsigned nrLayers = 0;
+  for (auto speed = this->trickPlaySpeed; speed > 1; speed /= 2)
+    nrLayers++;
+  return nrLayers;
+}
+
 QString PlaybackController::getStatus()
 {
   QString status;
   status += "Downloader: " + this->downloader->getStatus() + "\n";
   status += "Parser: " + this->parser->getStatus() + "\n";
-  status += "Decoder: " + this->decoder->getStatus() + "\n";
+  if (this->decoders.empty())
+    status += "Decoder: None\n";
+  else if (this->decoders.size() == 1)
+    status += "Decoder: " + this->decoders.front()->getStatus() + "\n";
+  else
+  {
+    double totalFPS = 0.0;
+    for (size_t i = 0; i < this->decoders.size(); i++)
+    {
+      status += QString("Decoder %1: ").arg(i) + this->decoders[i]->getStatus() + "\n";
+      totalFPS += this->decoders[i]->getDecodingFPS();
+    }
+    status += QString("Decoders: %1 instances %2 fps\n")
+                  .arg(this->decoders.size())
+                  .arg(totalFPS, 0, 'f', 1);
+  }
   status += "Conversion: " + this->conversion->getStatus() + "\n";
+
+  auto memoryUsage = this->segmentBuffer->getMemoryUsage();
+  auto toMB        = [](std::size_t bytes) { return QString::number(bytes / BYTES_PER_MB); };
+  status += "Memory: " + toMB(memoryUsage.getTotalBytes());
+  if (auto budget = this->segmentBuffer->getMemoryBudget())
+    status += "/" + toMB(budget);
+  status += QString(" MB (compressed %1 YUV %2 RGB %3)")
+                .arg(toMB(memoryUsage.compressedBytes))
+                .arg(toMB(memoryUsage.yuvBytes))
+                .arg(toMB(memoryUsage.rgbBytes));
+  if (this->segmentBuffer->isMemoryBudgetExceeded())
+    status += " Budget reached";
+  status += "\n";
+  if (this->trickPlaySpeed > 1)
+    status += QString("Trick play: %1x (%2 temporal layers skipped)\n")
+                  .arg(this->trickPlaySpeed)
+                  .arg(this->getNrTemporalLayersToSkip());
   return status;
 }
 
+std::vector<DecoderStatistics::Snapshot> PlaybackController::getDecoderStatistics() const
+{
+  std::vector<DecoderStatistics::Snapshot> snapshots;
+  for (size_t i = 0; i < this->decoders.size(); i++)
+  {
+    auto snapshot     = this->decoders[i]->getStatistics();
+    snapshot.instance = unsigned(i);
+    snapshots.push_back(snapshot);
+  }
+  return snapshots;
+}
+
+FileDownloader::Statistics PlaybackController::getDownloadStatistics() const
+{
+  return this->downloader->getStatistics();
+}
+
+StageStatistics::Snapshot PlaybackController::getParserStatistics() const
+{
+  return this->parser->getStatistics();
+}
+
+StageStatistics::Snapshot PlaybackController::getConversionStatistics() const
+{
+  return this->conversion->getStatistics();
+}
+
 void PlaybackController::activateManifest()
 {
+  // The decoder is created once the manifest is known because the manifest may contain decoder
+  // settings. Settings from the command line have priority over settings from the manifest which
+  // have priority over the application settings.
+  if (this->decoders.empty())
+  {
+    auto decoderSettings = decoder::DecoderSettings::fromApplicationSettings();
+    decoderSettings.override(this->manifestFile->getDecoderSettings());
+    decoderSettings.override(this->commandLineDecoderSettings);
+    this->logger->addMessage("Decoder settings: " + decoderSettings.toString(),
+                             LoggingPriority::Info);
+
+    // Closed GOP segments can be decoded independently by multiple decoders in parallel
+    auto nrInstances = std::max(decoderSettings.instances.value_or(1), 1);
+    if (this->manifestFile->isopenGopAdaptiveResolutionChange() && nrInstances > 1)
+    {
+      this->logger->addMessage("Open GOP adaptive resolution change requires a single decoder",
+                               LoggingPriority::Info);
+      nrInstances = 1;
+    }
+
+    auto segmentMode = (nrInstances > 1) ? DecoderThread::SegmentMode::Independent
+                                         : DecoderThread::SegmentMode::Sequential;
+    for (int i = 0; i < nrInstances; i++)
+      this->decoders.push_back(std::make_unique<DecoderThread>(
+          this->logger, this->segmentBuffer.get(), decoderSettings, segmentMode));
+  }
+  this->segmentBuffer->setMemoryBudget(this->manifestFile->getMemoryBudgetMB() * BYTES_PER_MB);
+
+  for (auto &decoder : this->decoders)
+  {
+    decoder->setOpenGopAdaptiveResolutionChange(
+        this->manifestFile->isopenGopAdaptiveResolutionChange());
+    decoder->setNrTemporalLayersToSkip(this->getNrTemporalLayersToSkip());
+  }
+
   if (this->manifestFile->isopenGopAdaptiveResolutionChange())
   {
     this->highestRenditionFirstSegment = std::make_unique<Segment>();
@@ -131,7 +267,7 @@ void PlaybackController::activateManifest()
   this->fillDownloadQueue();
 }
 
-void PlaybackController::downloadOfSegmentFinished()
+void PlaybackController::downloadOfSegmentFinished(Segment *segment)
 {
   if (this->highestRenditionFirstSegment)
   {
@@ -141,13 +277,14 @@ void PlaybackController::downloadOfSegmentFinished()
     this->highestRenditionFirstSegment.reset();
   }
   else
-    this->segmentBuffer->onDownloadOfSegmentFinished();
+    this->segmentBuffer->onDownloadOfSegmentFinished(segment);
 }
 
 void PlaybackController::fillDownloadQueue()
 {
   while (this->segmentBuffer->getNrOfBufferedSegments() <
-         this->manifestFile->getMaxSegmentBufferSize())
+             this->manifestFile->getMaxSegmentBufferSize() &&
+         this->segmentBuffer->canAddSegment())
   {
     auto segment         = this->segmentBuffer->getNextDownloadSegment();
     segment->segmentInfo = this->manifestFile->getNextSegmentInfo();
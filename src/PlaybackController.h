@@ -40,7 +40,7 @@ class PlaybackController : public QObject
   Q_OBJECT
 
 public:
-  PlaybackController(ILogger *logger);
+  PlaybackController(ILogger *logger, decoder::DecoderSettings commandLineDecoderSettings = {});
   ~PlaybackController();
 
   void reset();
@@ -52,14 +52,31 @@ public:
   void increaseRendition();
   void decreaseRendition();
 
+  // Trick play with 1, 2, 4 or 8 times the normal speed. For every doubling of the speed, the
+  // decoders skip the highest remaining temporal sub-layer.
+  static constexpr unsigned MAX_TRICK_PLAY_SPEED = 8;
+  void                      setTrickPlaySpeed(unsigned speed);
+  unsigned                  getTrickPlaySpeed() const { return this->trickPlaySpeed; }
+
   QString getStatus();
+
+  // The statistics of all decoder instances
+  std::vector<DecoderStatistics::Snapshot> getDecoderStatistics() const;
+  FileDownloader::Statistics               getDownloadStatistics() const;
+  StageStatistics::Snapshot                getParserStatistics() const;
+  StageStatistics::Snapshot                getConversionStatistics() const;
   auto    getLastSegmentsData() -> std::deque<SegmentData>;
 
+  // Turn off the conversion to RGB if the view renders the YUV data itself
+  void setConvertFramesToRGB(bool convertToRGB);
+  // Convert frames directly to the size they are displayed with (see FrameConversionThread)
+  void setConversionTargetSize(Size targetSize);
+
   SegmentBuffer *getSegmentBuffer() { return this->segmentBuffer.get(); }
   ManifestFile * getManifest() { return this->manifestFile.get(); }
 
 private slots:
-  void downloadOfSegmentFinished();
+  void downloadOfSegmentFinished(Segment *segment);
   void fillDownloadQueue();
 
 private:
@@ -67,11 +84,19 @@ private:
 
   ILogger *logger{};
 
-  std::unique_ptr<FileDownloader>        downloader;
-  std::unique_ptr<DecoderThread>         decoder;
-  std::unique_ptr<FileParserThread>      parser;
-  std::unique_ptr<FrameConversionThread> conversion;
-  std::unique_ptr<SegmentBuffer>         segmentBuffer;
+  unsigned trickPlaySpeed{1};
+  bool     convertFramesToRGB{true};
+  Size     conversionTargetSize{};
+  unsigned getNrTemporalLayersToSkip() const;
+
+  // Decoder settings given on the command line. These have the highest priority.
+  decoder::DecoderSettings commandLineDecoderSettings;
+
+  std::unique_ptr<FileDownloader>             downloader;
+  std::vector<std::unique_ptr<DecoderThread>> decoders;
+  std::unique_ptr<FileParserThread>           parser;
+  std::unique_ptr<FrameConversionThread>      conversion;
+  std::unique_ptr<SegmentBuffer>              segmentBuffer;
 
   std::unique_ptr<Segment> highestRenditionFirstSegment;
 
@@ -23,6 +23,7 @@ SOFTWARE. */
 
 #include "SegmentBuffer.h"
 
+#include <algorithm>
 #include <assert.h>
 
 #define DEBUG_SEGMENT_BUFFER 0
@@ -36,6 +37,15 @@ SOFTWARE. */
 namespace
 {
 
+// The displayed segment and the one after it must always be processed. Otherwise the display
+// could not move on to the next segment, and no segment would ever be removed from the buffer.
+constexpr std::size_t NR_SEGMENTS_IGNORING_MEMORY_BUDGET = 2;
+
+std::size_t getImageBytes(const QImage &image)
+{
+  return std::size_t(image.bytesPerLine()) * std::size_t(image.height());
+}
+
 Segment *getNextSegmentFromQueue(Segment *                             curSegment,
                                  std::deque<std::unique_ptr<Segment>> &segments)
 {
@@ -51,6 +61,17 @@ Segment *getNextSegmentFromQueue(Segment *                             curSegmen
   return segmentIt->get();
 }
 
+Segment *getFirstUnclaimedSegment(std::deque<std::unique_ptr<Segment>> &segments)
+{
+  auto segmentIt = std::find_if(
+      segments.begin(), segments.end(), [](const std::unique_ptr<Segment> &segment) {
+        return !segment->claimedForDecoding;
+      });
+  if (segmentIt == segments.end())
+    return {};
+  return segmentIt->get();
+}
+
 SegmentBuffer::FrameIterator getNextFrame(const SegmentBuffer::FrameIterator &  frameIterator,
                                           std::deque<std::unique_ptr<Segment>> &segments)
 {
@@ -92,37 +113,95 @@ void SegmentBuffer::abort()
   this->eventCV.notify_all();
 }
 
-std::vector<SegmentBuffer::SegmentRenderInfo>
-SegmentBuffer::getBufferStatusForRender(Frame *curPlaybackFrame)
+std::shared_ptr<const SegmentBuffer::BufferStatus> SegmentBuffer::getBufferStatusForRender() const
 {
-  std::unique_lock               lk(this->segmentQueueMutex);
-  std::vector<SegmentRenderInfo> states;
+  return std::atomic_load(&this->bufferStatus);
+}
+
+void SegmentBuffer::publishBufferStatus()
+{
+  // Only one thread builds a snapshot at a time so that an older snapshot can not replace a newer
+  // one. The GUI thread also publishes a snapshot when it adds or removes a segment, and may then
+  // wait shortly for a snapshot that another thread is building. Painting only reads the last
+  // snapshot and never waits.
+  std::scoped_lock publishLock(this->bufferStatusMutex);
+  std::shared_lock lk(this->segmentQueueMutex);
+
+  auto status = std::make_shared<BufferStatus>();
+  status->reserve(this->segments.size());
   for (auto &segment : this->segments)
   {
     SegmentRenderInfo segmentInfo;
     segmentInfo.downloadProgress = segment->downloadProgress;
     segmentInfo.sizeInBytes      = segment->compressedSizeBytes;
-    segmentInfo.nrFrames         = segment->nrFrames;
     segmentInfo.segmentNumber    = segment->segmentInfo.segmentNumber;
     segmentInfo.renditionNumber  = segment->segmentInfo.rendition;
-    unsigned frameCounter        = 0;
-    for (auto &frame : segment->frames)
+    // While the parser adds frames, the list of frames of the segment can not be read
+    if (segment->parsingFinished)
     {
-      SegmentRenderInfo::FrameInfo frameInfo;
-      frameInfo.frameState  = frame->frameState;
-      frameInfo.sizeInBytes = frame->nrBytesCompressed;
-      segmentInfo.frameInfo.push_back(frameInfo);
-      if (frame.get() == curPlaybackFrame)
-        segmentInfo.indexOfCurFrameInFrames = frameCounter;
-      frameCounter++;
+      segmentInfo.nrFrames = segment->nrFrames;
+      segmentInfo.frameInfo.reserve(segment->frames.size());
+      for (auto &frame : segment->frames)
+      {
+        SegmentRenderInfo::FrameInfo frameInfo;
+        frameInfo.frame       = frame.get();
+        frameInfo.frameState  = frame->frameState;
+        frameInfo.dropped     = frame->dropped;
+        frameInfo.sizeInBytes = frame->nrBytesCompressed;
+        segmentInfo.frameInfo.push_back(frameInfo);
+      }
     }
-    states.push_back(segmentInfo);
+    status->push_back(std::move(segmentInfo));
   }
-  return states;
+
+  std::atomic_store(&this->bufferStatus, std::shared_ptr<const BufferStatus>(std::move(status)));
 }
 
 size_t SegmentBuffer::getNrOfBufferedSegments() { return this->segments.size(); }
 
+SegmentBuffer::MemoryUsage SegmentBuffer::getMemoryUsage() const
+{
+  MemoryUsage usage;
+  usage.compressedBytes = this->compressedBytes;
+  usage.yuvBytes        = this->yuvBytes;
+  usage.rgbBytes        = this->rgbBytes;
+  return usage;
+}
+
+void SegmentBuffer::setMemoryBudget(std::size_t budgetBytes)
+{
+  DEBUG("SegmentBuffer: Set memory budget " << budgetBytes);
+  this->memoryBudget = budgetBytes;
+  this->eventCV.notify_all();
+}
+
+bool SegmentBuffer::isMemoryBudgetExceeded() const
+{
+  auto budget = this->memoryBudget.load();
+  return budget > 0 && this->getMemoryUsage().getTotalBytes() >= budget;
+}
+
+bool SegmentBuffer::canAddSegment()
+{
+  std::shared_lock lk(this->segmentQueueMutex);
+  return this->segments.size() < NR_SEGMENTS_IGNORING_MEMORY_BUDGET ||
+         !this->isMemoryBudgetExceeded();
+}
+
+bool SegmentBuffer::isSegmentAllowedByMemoryBudget(const Segment *segment) const
+{
+  if (!this->isMemoryBudgetExceeded())
+    return true;
+
+  auto endOfAllowedSegments =
+      this->segments.begin() + std::min(this->segments.size(), NR_SEGMENTS_IGNORING_MEMORY_BUDGET);
+  return std::any_of(this->segments.begin(),
+                     endOfAllowedSegments,
+                     [segment](const std::unique_ptr<Segment> &bufferSegment) {
+                       return bufferSegment.get() == segment;
+                     });
+}
+
 Segment *SegmentBuffer::getNextDownloadSegment()
 {
   DEBUG("SegmentBuffer: Get next segment");
@@ -133,15 +212,22 @@ Segment *SegmentBuffer::getNextDownloadSegment()
     return {};
   }
 
-  if (this->segmentRecycleBin.empty())
-    this->segments.emplace_back(std::make_unique<Segment>());
-  else
+  Segment *segment{};
   {
-    this->segments.push_back(std::move(this->segmentRecycleBin.front()));
-    this->segmentRecycleBin.pop();
+    // The other threads iterate over the segments while holding a shared lock
+    std::unique_lock lk(this->segmentQueueMutex);
+    if (this->segmentRecycleBin.empty())
+      this->segments.emplace_back(std::make_unique<Segment>());
+    else
+    {
+      this->segments.push_back(std::move(this->segmentRecycleBin.front()));
+      this->segmentRecycleBin.pop();
+    }
+    segment = this->segments.back().get();
   }
 
-  return this->segments.back().get();
+  this->publishBufferStatus();
+  return segment;
 }
 
 Frame *SegmentBuffer::addNewFrameToSegment(Segment *segment)
@@ -160,7 +246,14 @@ Frame *SegmentBuffer::addNewFrameToSegment(Segment *segment)
   return segment->frames.back().get();
 }
 
-void SegmentBuffer::onDownloadOfSegmentFinished() { this->eventCV.notify_all(); }
+void SegmentBuffer::onDownloadOfSegmentFinished(Segment *segment)
+{
+  this->compressedBytes += std::size_t(segment->compressedData.size());
+  this->publishBufferStatus();
+  this->eventCV.notify_all();
+}
+
+void SegmentBuffer::onDownloadProgress() { this->publishBufferStatus(); }
 
 Segment *SegmentBuffer::getFirstSegmentToParse()
 {
@@ -189,6 +282,7 @@ Segment *SegmentBuffer::getFirstSegmentToParse()
 Segment *SegmentBuffer::getNextSegmentToParse(Segment *segmentPtr)
 {
   DEBUG("SegmentBuffer: Waiting for next segment to parse");
+  this->publishBufferStatus();
   this->eventCV.notify_all();
 
   std::shared_lock lk(this->segmentQueueMutex);
@@ -221,7 +315,7 @@ Segment *SegmentBuffer::getFirstSegmentToDecode()
       return true;
     if (this->segments.size() == 0)
       return false;
-    return (*this->segments.begin())->parsingFinished;
+    return (*this->segments.begin())->parsingFinished.load();
   });
 
   if (this->aborted)
@@ -244,7 +338,7 @@ Segment *SegmentBuffer::getNextSegmentToDecode(Segment *segmentPtr)
     if (this->aborted)
       return true;
     if (auto nextSegment = getNextSegmentFromQueue(segmentPtr, this->segments))
-      return nextSegment->parsingFinished;
+      return nextSegment->parsingFinished && this->isSegmentAllowedByMemoryBudget(nextSegment);
     return false;
   });
 
@@ -258,10 +352,104 @@ Segment *SegmentBuffer::getNextSegmentToDecode(Segment *segmentPtr)
   return getNextSegmentFromQueue(segmentPtr, this->segments);
 }
 
-void SegmentBuffer::onFrameDecoded()
+Segment *SegmentBuffer::claimNextSegmentToDecode()
 {
+  DEBUG("SegmentBuffer: Waiting for next segment to claim for decoding");
+  this->eventCV.notify_all();
+
+  std::shared_lock lk(this->segmentQueueMutex);
+  while (true)
+  {
+    Segment *segment{};
+    this->eventCV.wait(lk, [this, &segment]() {
+      if (this->aborted)
+        return true;
+      segment = getFirstUnclaimedSegment(this->segments);
+      return segment != nullptr && segment->parsingFinished &&
+             this->isSegmentAllowedByMemoryBudget(segment);
+    });
+
+    if (this->aborted)
+    {
+      DEBUG("SegmentBuffer: No segment claimed because of abort");
+      return {};
+    }
+
+    // Another decoder may have claimed the segment in the meantime
+    if (!segment->claimedForDecoding.exchange(true))
+    {
+      DEBUG("SegmentBuffer: Claimed segment " << segment->segmentInfo.segmentNumber);
+      return segment;
+    }
+  }
+}
+
+void SegmentBuffer::onFrameDecoded(Frame &frame)
+{
+  {
+    std::shared_lock lk(this->segmentQueueMutex);
+    this->yuvBytes += std::size_t(frame.rawYUVData.size());
+    frame.frameState = FrameState::Decoded;
+  }
+
   // Whenever a frame was decoded we can already convert it
+  this->publishBufferStatus();
+  this->eventCV.notify_all();
+}
+
+bool SegmentBuffer::dropUnfinishedFrames(Segment &segment, uint64_t generation)
+{
+  {
+    // Recycling takes the lock exclusively, so the segment can not be reused while it is checked
+    std::shared_lock lk(this->segmentQueueMutex);
+    if (segment.generation != generation)
+    {
+      DEBUG("SegmentBuffer: Not dropping frames of recycled segment");
+      return false;
+    }
+
+    for (auto &frame : segment.frames)
+    {
+      if (frame->frameState == FrameState::Empty)
+      {
+        DEBUG("SegmentBuffer: Dropping frame that was not decoded");
+        frame->dropped    = true;
+        frame->frameState = FrameState::Decoded;
+      }
+    }
+  }
+
+  this->publishBufferStatus();
   this->eventCV.notify_all();
+  return true;
+}
+
+unsigned SegmentBuffer::getNrOfFramesReadyAhead()
+{
+  std::shared_lock lk(this->segmentQueueMutex);
+
+  auto     displayedFrame      = this->lastDisplayedFrame.load();
+  bool     displayedFrameFound = (displayedFrame == nullptr);
+  unsigned nrFramesReady       = 0;
+  for (const auto &segment : this->segments)
+  {
+    // While the parser adds frames, the list of frames of the segment can not be read. None of
+    // them is decoded yet anyway.
+    if (!segment->parsingFinished)
+      return nrFramesReady;
+    for (const auto &frame : segment->frames)
+    {
+      if (!displayedFrameFound)
+      {
+        displayedFrameFound = (frame.get() == displayedFrame);
+        continue;
+      }
+      if (frame->frameState == FrameState::Empty)
+        return nrFramesReady;
+      nrFramesReady++;
+    }
+  }
+  return nrFramesReady;
 }
 
 SegmentBuffer::FrameIterator SegmentBuffer::getFirstFrameToConvert()
@@ -289,11 +477,22 @@ SegmentBuffer::FrameIterator SegmentBuffer::getFirstFrameToConvert()
   return {this->segments.front().get(), this->segments.front()->frames.front().get()};
 }
 
+void SegmentBuffer::onFrameConverted(Frame &frame)
+{
+  {
+    std::shared_lock lk(this->segmentQueueMutex);
+    this->rgbBytes += getImageBytes(frame.rgbImage);
+    frame.frameState = FrameState::ConvertedToRGB;
+  }
+
+  this->publishBufferStatus();
+  this->eventCV.notify_all();
+}
+
 SegmentBuffer::FrameIterator SegmentBuffer::getNextFrameToConvert(FrameIterator frameIt)
 {
   assert(!frameIt.isNull());
   DEBUG("Waiting for next frame to convert.");
-  this->eventCV.notify_all();
 
   std::shared_lock lk(this->segmentQueueMutex);
   this->eventCV.wait(lk, [this, frameIt]() {
@@ -302,7 +501,8 @@ SegmentBuffer::FrameIterator SegmentBuffer::getNextFrameToConvert(FrameIterator
     auto nextFrame = getNextFrame(frameIt, this->segments);
     if (nextFrame.isNull())
       return false;
-    return nextFrame.frame->frameState == FrameState::Decoded;
+    return nextFrame.frame->frameState == FrameState::Decoded &&
+           this->isSegmentAllowedByMemoryBudget(nextFrame.segment);
   });
 
   if (this->aborted)
@@ -340,6 +540,7 @@ SegmentBuffer::FrameIterator SegmentBuffer::getFirstFrameToDisplay()
   }
 
   DEBUG("First frame to display ready.");
+  this->lastDisplayedFrame = firstSegment->frames.front().get();
   this->eventCV.notify_all();
   return {firstSegment.get(), firstSegment->frames.front().get()};
 }
@@ -365,24 +566,40 @@ SegmentBuffer::FrameIterator SegmentBuffer::getNextFrameToDisplay(FrameIterator
 
   if (frameIt.segment != nextFrame.segment)
   {
-    assert(frameIt.segment == this->segments.front().get());
-    this->recycleSegmentAndFrames(std::move(this->segments.front()));
-    this->segments.pop_front();
+    // Removing the segment needs exclusive access. Only the player removes segments, so the
+    // next frame stays valid in between.
+    lk.unlock();
+    {
+      std::unique_lock writeLock(this->segmentQueueMutex);
+      assert(frameIt.segment == this->segments.front().get());
+      this->recycleSegmentAndFrames(std::move(this->segments.front()));
+      this->segments.pop_front();
+    }
+    this->publishBufferStatus();
     emit segmentRemovedFromBuffer();
   }
 
   DEBUG("Next frame to display ready.");
+  this->lastDisplayedFrame = nextFrame.frame;
   this->eventCV.notify_all();
   return nextFrame;
 }
 
 void SegmentBuffer::recycleSegmentAndFrames(std::unique_ptr<Segment> &&segment)
 {
+  // The data is released so that recycled segments and frames don't hold any memory. It is
+  // replaced (not reused) when the segment or frame is filled again.
   for (auto &frameIt : segment->frames)
   {
+    this->yuvBytes -= std::size_t(frameIt->rawYUVData.size());
+    this->rgbBytes -= getImageBytes(frameIt->rgbImage);
+    frameIt->rawYUVData = {};
+    frameIt->rgbImage   = {};
     frameIt->clear();
     this->frameRecycleBin.push(std::move(frameIt));
   }
+  this->compressedBytes -= std::size_t(segment->compressedData.size());
+  segment->compressedData = {};
   segment->clear();
   this->segmentRecycleBin.push(std::move(segment));
 }
@@ -26,9 +26,12 @@ SOFTWARE. */
 #include <common/Segment.h>
 
 #include <QObject>
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <shared_mutex>
@@ -63,24 +66,57 @@ public:
 
   struct SegmentRenderInfo
   {
-    double                  downloadProgress{};
-    std::size_t             sizeInBytes{};
-    unsigned                nrFrames{};
-    std::optional<unsigned> indexOfCurFrameInFrames;
-    unsigned                segmentNumber{};
-    unsigned                renditionNumber{};
+    double      downloadProgress{};
+    std::size_t sizeInBytes{};
+    unsigned    nrFrames{};
+    unsigned    segmentNumber{};
+    unsigned    renditionNumber{};
 
     struct FrameInfo
     {
-      FrameState  frameState{};
-      std::size_t sizeInBytes{};
+      // Only compared against. Never dereferenced.
+      const Frame *frame{};
+      FrameState   frameState{};
+      bool         dropped{};
+      std::size_t  sizeInBytes{};
     };
     std::vector<FrameInfo> frameInfo;
   };
-  std::vector<SegmentRenderInfo> getBufferStatusForRender(Frame *curPlaybackFrame);
+  using BufferStatus = std::vector<SegmentRenderInfo>;
+
+  // A snapshot of the buffer for visualization. The snapshot is rebuilt by the pipeline threads
+  // whenever something changes and swapped in atomically, so reading it never takes the lock.
+  std::shared_ptr<const BufferStatus> getBufferStatusForRender() const;
 
   size_t getNrOfBufferedSegments();
 
+  // The memory that is held by the segments in the buffer. This is the compressed data of all
+  // downloaded segments and the YUV and RGB data of all decoded and converted frames. The image
+  // of the ViewWidget is not counted. This is the image that it converts itself if a frame was
+  // not converted to RGB, or the image of the shown frame that it keeps after the frame was
+  // recycled. It is at most one frame.
+  struct MemoryUsage
+  {
+    std::size_t compressedBytes{};
+    std::size_t yuvBytes{};
+    std::size_t rgbBytes{};
+    std::size_t getTotalBytes() const { return compressedBytes + yuvBytes + rgbBytes; }
+  };
+  MemoryUsage getMemoryUsage() const;
+
+  /* Limit the memory of the buffer (0 for no limit). While the memory usage is at or above the
+   * budget, no new segment is downloaded or decoded and no frame is converted. Each stage is only
+   * held back as long as it would add to the memory. The first two segments in the buffer (the
+   * displayed one and the next one) are never held back so that playback can always continue.
+   * The budget is checked before a segment is started, so it may be exceeded by up to about one
+   * segment.
+   */
+  void        setMemoryBudget(std::size_t budgetBytes);
+  std::size_t getMemoryBudget() const { return this->memoryBudget; }
+  bool        isMemoryBudgetExceeded() const;
+  // Another segment may be added (downloaded) without exceeding the memory budget
+  bool canAddSegment();
+
   // These provide new (or maybe recycled) segments/frames. These do not block.
   Segment *getNextDownloadSegment();
   Frame *  addNewFrameToSegment(Segment *segment);
@@ -93,18 +129,38 @@ public:
   // decoded frames are already in the buffer)
   Segment *getFirstSegmentToDecode();
   Segment *getNextSegmentToDecode(Segment *segment);
-  void     onFrameDecoded();
+  // The decoder stored the YUV data of the frame (or dropped it). This accounts the data and then
+  // marks the frame as decoded. Both happen under the lock, so the frame can not be recycled
+  // (which subtracts its data again) before its data was accounted.
+  void onFrameDecoded(Frame &frame);
+  // Mark all frames of the segment that were not decoded as dropped. Nothing is done if the
+  // segment is no longer of the given generation, because it was then displayed and recycled and
+  // its frames now belong to another segment. Returns false in that case.
+  bool dropUnfinishedFrames(Segment &segment, uint64_t generation);
+
+  // The number of frames directly following the displayed frame that are already decoded (or
+  // dropped). The decoder uses this to detect that it falls behind.
+  unsigned getNrOfFramesReadyAhead();
+
+  // If segments are decoded independently by multiple decoders, each decoder claims the next
+  // segment in order here. Each segment is only returned once. Blocks until the next segment
+  // is parsed.
+  Segment *claimNextSegmentToDecode();
 
   // The converter will get frames to convert here (and may get blocked if there
   // are none)
   FrameIterator getFirstFrameToConvert();
+  // The converter stored the RGB image of the frame. Like onFrameDecoded, this accounts the image
+  // before the frame is marked as converted.
+  void          onFrameConverted(Frame &frame);
   FrameIterator getNextFrameToConvert(FrameIterator frameIt);
 
   // The player will get frames to display here (and may get none (end) if there is none available)
   FrameIterator getFirstFrameToDisplay();
   FrameIterator getNextFrameToDisplay(FrameIterator frameIt);
 
-  void onDownloadOfSegmentFinished();
+  void onDownloadOfSegmentFinished(Segment *segment);
+  void onDownloadProgress();
 
 signals:
   void segmentRemovedFromBuffer();
@@ -117,6 +173,20 @@ private:
 
   bool aborted{false};
 
+  // Only compared against. Never dereferenced.
+  std::atomic<Frame *> lastDisplayedFrame{};
+
+  std::atomic<std::size_t> memoryBudget{};
+  std::atomic<std::size_t> compressedBytes{};
+  std::atomic<std::size_t> yuvBytes{};
+  std::atomic<std::size_t> rgbBytes{};
+  // Segments near the front of the buffer are processed even if the budget is exceeded
+  bool isSegmentAllowedByMemoryBudget(const Segment *segment) const;
+
+  std::shared_ptr<const BufferStatus> bufferStatus;
+  std::mutex                          bufferStatusMutex;
+  void                                publishBufferStatus();
+
   void                                 recycleSegmentAndFrames(std::unique_ptr<Segment> &&segment);
   std::queue<std::unique_ptr<Segment>> segmentRecycleBin;
   std::queue<std::unique_ptr<Frame>>   frameRecycleBin;
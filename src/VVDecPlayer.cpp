@@ -23,8 +23,27 @@ SOFTWARE. */
 
 #include "VVDecPlayerApplication.h"
 
+#include <QSurfaceFormat>
+#include <cstring>
+
 int main(int argc, char *argv[])
 {
+  // The headless modes must also run on machines without a display
+  for (int i = 1; i < argc; i++)
+  {
+    auto isHeadless = std::strncmp(argv[i], "--headless", 10) == 0 ||
+                      std::strncmp(argv[i], "--benchmark", 11) == 0;
+    if (isHeadless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  // The view presents the frames on the buffer swaps, so these must wait for the vertical blank.
+  // For a QOpenGLWidget this depends on the top level window, so it has to be set as the default
+  // before the application is created.
+  auto surfaceFormat = QSurfaceFormat::defaultFormat();
+  surfaceFormat.setSwapInterval(1);
+  QSurfaceFormat::setDefaultFormat(surfaceFormat);
+
   VVDecPlayerApplication app(argc, argv);
   return app.returnCode;
 }
@@ -23,9 +23,18 @@ SOFTWARE. */
 
 #include "VVDecPlayerApplication.h"
 
+#include <cli/ConversionBenchmark.h>
+#include <cli/HeadlessPlayback.h>
+#include <cli/LargeAccessUnitCheck.h>
+#include <cli/ParserBenchmark.h>
+#include <cli/PipelineBenchmark.h>
+#include <cli/SegmentIndexGenerator.h>
+#include <cli/SyntheticBitstream.h>
+#include <common/ConsoleLogger.h>
 #include <ui/MainWindow.h>
 
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QSettings>
 
 #define APPLICATION_DEBUG 0
@@ -51,7 +60,278 @@ VVDecPlayerApplication::VVDecPlayerApplication(int argc, char *argv[]) : QApplic
   auto args = arguments();
   DEBUG_APP("vvDecPlayer args" << args);
 
-  MainWindow w;
+  QCommandLineParser parser;
+  parser.setApplicationDescription("A player for segmented VVC streams");
+  parser.addHelpOption();
+  parser.addVersionOption();
+
+  QCommandLineOption generateIndexOption(
+      "generate-index",
+      "Write a segment index file next to every segment of the given local manifest and exit.",
+      "manifest");
+  parser.addOption(generateIndexOption);
+
+  QCommandLineOption decoderEngineOption(
+      "decoder-engine", "The decoder to use (vvdec, synthetic).", "engine");
+  parser.addOption(decoderEngineOption);
+  QCommandLineOption decoderThreadsOption(
+      "decoder-threads", "Number of decoder threads (-1 for automatic).", "threads");
+  parser.addOption(decoderThreadsOption);
+  QCommandLineOption decoderParseThreadsOption(
+      "decoder-parse-threads",
+      "Number of decoder parse threads. Also sets the parse delay (-1 for automatic).",
+      "threads");
+  parser.addOption(decoderParseThreadsOption);
+  QCommandLineOption decoderSIMDOption(
+      "decoder-simd",
+      "SIMD extension for the decoder (default, scalar, sse41, sse42, avx, avx2, avx512).",
+      "simd");
+  parser.addOption(decoderSIMDOption);
+  QCommandLineOption decoderUpscalingOption(
+      "decoder-upscaling", "Upscaling of RPR pictures (off, copy, rescale).", "mode");
+  parser.addOption(decoderUpscalingOption);
+  QCommandLineOption decoderInstancesOption(
+      "decoder-instances",
+      "Number of decoders that decode closed GOP segments in parallel.",
+      "instances");
+  parser.addOption(decoderInstancesOption);
+  QCommandLineOption decoderSkipNonReferenceOption(
+      "decoder-skip-non-reference",
+      "Skip non-reference pictures while fewer frames are decoded ahead (0 to never skip).",
+      "frames");
+  parser.addOption(decoderSkipNonReferenceOption);
+  QCommandLineOption syntheticSizeOption(
+      "synthetic-size", "Frame size of the synthetic decoder (default 1920x1080).", "WxH");
+  parser.addOption(syntheticSizeOption);
+  QCommandLineOption syntheticSubsamplingOption(
+      "synthetic-subsampling",
+      "Chroma subsampling of the synthetic decoder (420, 422, 444, 400).",
+      "subsampling");
+  parser.addOption(syntheticSubsamplingOption);
+  QCommandLineOption syntheticBitDepthOption(
+      "synthetic-bit-depth", "Bit depth of the synthetic decoder (default 10).", "bits");
+  parser.addOption(syntheticBitDepthOption);
+  QCommandLineOption syntheticLatencyOption(
+      "synthetic-latency",
+      "Time that the synthetic decoder takes for every frame in microseconds.",
+      "us");
+  parser.addOption(syntheticLatencyOption);
+
+  QCommandLineOption headlessOption(
+      "headless",
+      "Play the given manifest without a window as fast as possible and print a summary.",
+      "manifest");
+  parser.addOption(headlessOption);
+  QCommandLineOption benchmarkOption(
+      "benchmark",
+      "Play the given local manifest headless and write a JSON report of the pipeline performance.",
+      "manifest");
+  parser.addOption(benchmarkOption);
+  QCommandLineOption benchmarkOutputOption(
+      "benchmark-output", "Write the benchmark report to this file instead of stdout.", "file");
+  parser.addOption(benchmarkOutputOption);
+  QCommandLineOption benchmarkInstancesOption(
+      "benchmark-instances",
+      "Run the benchmark once for every number of decoder instances in the list (e.g. 1,2,4).",
+      "list");
+  parser.addOption(benchmarkInstancesOption);
+  QCommandLineOption headlessFramesOption(
+      "headless-frames",
+      "Number of frames to play in headless and benchmark mode (default 1000).",
+      "frames");
+  parser.addOption(headlessFramesOption);
+  QCommandLineOption headlessFPSOption(
+      "headless-fps", "Take the frames with a fixed rate in headless and benchmark mode.", "fps");
+  parser.addOption(headlessFPSOption);
+  QCommandLineOption headlessYUVOption(
+      "headless-yuv", "Do not convert the frames to RGB in headless and benchmark mode.");
+  parser.addOption(headlessYUVOption);
+  QCommandLineOption benchmarkConversionOption(
+      "benchmark-conversion",
+      "Measure the YUV to RGB conversion of all formats and sizes and write a JSON report.");
+  parser.addOption(benchmarkConversionOption);
+  QCommandLineOption benchmarkParserOption(
+      "benchmark-parser",
+      "Parse all VVC annex B files in the directory and write a JSON report of the throughput.",
+      "directory");
+  parser.addOption(benchmarkParserOption);
+  QCommandLineOption writeParserCorpusOption(
+      "write-parser-corpus",
+      "Write the synthetic VVC annex B files of the parser benchmark corpus to the directory.",
+      "directory");
+  parser.addOption(writeParserCorpusOption);
+  QCommandLineOption benchmarkFilterOption(
+      "benchmark-filter", "Only run the benchmark cases which contain this string.", "filter");
+  parser.addOption(benchmarkFilterOption);
+  QCommandLineOption goldenOption(
+      "golden", "Compare the benchmark results with the golden results in this file.", "file");
+  parser.addOption(goldenOption);
+  QCommandLineOption writeGoldenOption(
+      "write-golden", "Write the benchmark results as new golden results to this file.", "file");
+  parser.addOption(writeGoldenOption);
+  QCommandLineOption checkLargeAccessUnitOption(
+      "check-large-au",
+      "Check that access units larger than the decoder's initial payload buffer are split from a "
+      "synthetic stream and copied into the payload buffer without changes.");
+  parser.addOption(checkLargeAccessUnitOption);
+
+  parser.process(args);
+
+  if (parser.isSet(generateIndexOption))
+  {
+    returnCode = cli::generateSegmentIndexFiles(parser.value(generateIndexOption));
+    return;
+  }
+
+  if (parser.isSet(checkLargeAccessUnitOption))
+  {
+    returnCode = cli::runLargeAccessUnitCheck();
+    return;
+  }
+
+  if (parser.isSet(writeParserCorpusOption))
+  {
+    returnCode = cli::synthetic::writeParserCorpus(parser.value(writeParserCorpusOption));
+    return;
+  }
+
+  if (parser.isSet(benchmarkConversionOption) || parser.isSet(benchmarkParserOption))
+  {
+    cli::BenchmarkSettings benchmarkSettings;
+    benchmarkSettings.filter          = parser.value(benchmarkFilterOption);
+    benchmarkSettings.outputFile      = parser.value(benchmarkOutputOption);
+    benchmarkSettings.goldenFile      = parser.value(goldenOption);
+    benchmarkSettings.writeGoldenFile = parser.value(writeGoldenOption);
+    if (parser.isSet(benchmarkParserOption))
+      returnCode =
+          cli::runParserBenchmark(parser.value(benchmarkParserOption), benchmarkSettings);
+    else
+      returnCode = cli::runConversionBenchmark(benchmarkSettings);
+    return;
+  }
+
+  decoder::DecoderSettings decoderSettings;
+  if (parser.isSet(decoderEngineOption))
+  {
+    auto engine            = parser.value(decoderEngineOption).toLower().toStdString();
+    decoderSettings.engine = decoder::DecoderEngineMapper.getValue(engine);
+    if (!decoderSettings.engine)
+    {
+      ConsoleLogger().addMessage("Unknown decoder engine " + parser.value(decoderEngineOption),
+                                 LoggingPriority::Error);
+      returnCode = 1;
+      return;
+    }
+  }
+  if (parser.isSet(decoderThreadsOption))
+    decoderSettings.threads = parser.value(decoderThreadsOption).toInt();
+  if (parser.isSet(decoderParseThreadsOption))
+    decoderSettings.parseThreads = parser.value(decoderParseThreadsOption).toInt();
+  if (parser.isSet(decoderInstancesOption))
+    decoderSettings.instances = parser.value(decoderInstancesOption).toInt();
+  if (parser.isSet(decoderSkipNonReferenceOption))
+    decoderSettings.skipNonReferenceThreshold =
+        parser.value(decoderSkipNonReferenceOption).toInt();
+  if (parser.isSet(decoderSIMDOption))
+  {
+    auto simd            = parser.value(decoderSIMDOption).toLower().toStdString();
+    decoderSettings.simd = decoder::SIMDExtensionMapper.getValue(simd);
+    if (!decoderSettings.simd)
+    {
+      ConsoleLogger().addMessage("Unknown SIMD extension " + parser.value(decoderSIMDOption),
+                                 LoggingPriority::Error);
+      returnCode = 1;
+      return;
+    }
+  }
+  if (parser.isSet(decoderUpscalingOption))
+  {
+    auto upscaling            = parser.value(decoderUpscalingOption).toLower().toStdString();
+    decoderSettings.upscaling = decoder::UpscalingModeMapper.getValue(upscaling);
+    if (!decoderSettings.upscaling)
+    {
+      ConsoleLogger().addMessage("Unknown upscaling mode " + parser.value(decoderUpscalingOption),
+                                 LoggingPriority::Error);
+      returnCode = 1;
+      return;
+    }
+  }
+
+  if (parser.isSet(syntheticSizeOption))
+  {
+    auto sizeValues = parser.value(syntheticSizeOption).toLower().split("x");
+    auto size       = (sizeValues.size() == 2) ? Size(sizeValues[0].toInt(), sizeValues[1].toInt())
+                                               : Size();
+    if (!size.isValid())
+    {
+      ConsoleLogger().addMessage("Invalid synthetic frame size " +
+                                     parser.value(syntheticSizeOption),
+                                 LoggingPriority::Error);
+      returnCode = 1;
+      return;
+    }
+    decoderSettings.synthetic.frameSize = size;
+  }
+  if (parser.isSet(syntheticSubsamplingOption))
+  {
+    auto subsampling = parser.value(syntheticSubsamplingOption).toStdString();
+    decoderSettings.synthetic.subsampling = video::yuv::SubsamplingMapper.getValue(subsampling);
+    if (!decoderSettings.synthetic.subsampling)
+    {
+      ConsoleLogger().addMessage("Unknown subsampling " + parser.value(syntheticSubsamplingOption),
+                                 LoggingPriority::Error);
+      returnCode = 1;
+      return;
+    }
+  }
+  if (parser.isSet(syntheticBitDepthOption))
+    decoderSettings.synthetic.bitDepth = parser.value(syntheticBitDepthOption).toInt();
+  if (parser.isSet(syntheticLatencyOption))
+    decoderSettings.synthetic.frameLatencyUs = parser.value(syntheticLatencyOption).toInt();
+
+  if (parser.isSet(headlessOption) || parser.isSet(benchmarkOption))
+  {
+    cli::HeadlessSettings headlessSettings;
+    if (parser.isSet(headlessFramesOption))
+      headlessSettings.nrFrames = parser.value(headlessFramesOption).toUInt();
+    if (parser.isSet(headlessFPSOption))
+      headlessSettings.framesPerSecond = parser.value(headlessFPSOption).toDouble();
+    headlessSettings.renderYUV = parser.isSet(headlessYUVOption);
+
+    if (parser.isSet(benchmarkOption))
+    {
+      std::vector<int> instanceSweep;
+      if (parser.isSet(benchmarkInstancesOption))
+      {
+        for (const auto &value : parser.value(benchmarkInstancesOption).split(","))
+        {
+          auto nrInstances = value.trimmed().toInt();
+          if (nrInstances < 1)
+          {
+            ConsoleLogger().addMessage("Invalid number of decoder instances " + value,
+                                       LoggingPriority::Error);
+            returnCode = 1;
+            return;
+          }
+          instanceSweep.push_back(nrInstances);
+        }
+      }
+
+      headlessSettings.manifestFile = parser.value(benchmarkOption);
+      returnCode                    = cli::runPipelineBenchmark(headlessSettings,
+                                                 decoderSettings,
+                                                 parser.value(benchmarkOutputOption),
+                                                 instanceSweep);
+    }
+    else
+    {
+      headlessSettings.manifestFile = parser.value(headlessOption);
+      returnCode = cli::runHeadlessPlayback(headlessSettings, decoderSettings);
+    }
+    return;
+  }
+
+  MainWindow w(decoderSettings);
   this->installEventFilter(&w);
 
   w.show();
@@ -0,0 +1,195 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "BenchmarkCommon.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+namespace cli
+{
+
+namespace
+{
+
+constexpr auto GOLDEN_FILE_VERSION = 1;
+
+} // namespace
+
+bool needsMoreIterations(size_t nrIterations, BenchmarkClock::time_point caseStart)
+{
+  if (nrIterations >= MAX_ITERATIONS)
+    return false;
+  return nrIterations < MIN_ITERATIONS || BenchmarkClock::now() - caseStart < MIN_CASE_TIME;
+}
+
+double toMilliseconds(BenchmarkClock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+QJsonObject getPercentiles(std::vector<double> values)
+{
+  QJsonObject percentiles;
+  percentiles["Count"] = qint64(values.size());
+  if (values.empty())
+    return percentiles;
+
+  std::sort(values.begin(), values.end());
+  auto percentile = [&values](double p) {
+    auto rank = size_t(std::ceil(p / 100.0 * double(values.size())));
+    return values.at(std::clamp(rank, size_t(1), values.size()) - 1);
+  };
+
+  percentiles["Mean"] =
+      std::accumulate(values.begin(), values.end(), 0.0) / double(values.size());
+  percentiles["P50"] = percentile(50);
+  percentiles["P90"] = percentile(90);
+  percentiles["P99"] = percentile(99);
+  percentiles["Max"] = values.back();
+  return percentiles;
+}
+
+bool writeReport(const QJsonObject &report, const QString &fileName, ILogger &logger)
+{
+  auto json = QJsonDocument(report).toJson();
+  if (fileName.isEmpty())
+  {
+    std::cout << json.toStdString();
+    return true;
+  }
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+  {
+    logger.addMessage(QString("Error writing report %1").arg(fileName), LoggingPriority::Error);
+    return false;
+  }
+  return true;
+}
+
+std::optional<QJsonObject> readGoldenFile(const QString &fileName, ILogger &logger)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+  {
+    logger.addMessage(QString("Error reading golden file %1").arg(fileName),
+                      LoggingPriority::Error);
+    return {};
+  }
+
+  auto document = QJsonDocument::fromJson(file.readAll());
+  if (!document.isObject() || document.object()["Version"].toInt() != GOLDEN_FILE_VERSION)
+  {
+    logger.addMessage(QString("Golden file %1 has an unknown format").arg(fileName),
+                      LoggingPriority::Error);
+    return {};
+  }
+  return document.object()["Results"].toObject();
+}
+
+bool writeGoldenFile(const QString &fileName, const QJsonObject &results, ILogger &logger)
+{
+  QJsonObject golden;
+  golden["Version"] = GOLDEN_FILE_VERSION;
+  golden["Results"] = results;
+
+  auto  json = QJsonDocument(golden).toJson();
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+  {
+    logger.addMessage(QString("Error writing golden file %1").arg(fileName),
+                      LoggingPriority::Error);
+    return false;
+  }
+  logger.addMessage(QString("Wrote %1 golden results to %2").arg(results.size()).arg(fileName),
+                    LoggingPriority::Info);
+  return true;
+}
+
+unsigned compareWithGolden(const QJsonObject &golden, const QJsonObject &results, ILogger &logger)
+{
+  auto toString = [](const QJsonValue &value) {
+    if (value.isString())
+      return value.toString();
+    if (value.isDouble())
+      return QString::number(value.toDouble());
+    auto document = value.isArray() ? QJsonDocument(value.toArray())
+                                    : QJsonDocument(value.toObject());
+    return QString::fromUtf8(document.toJson(QJsonDocument::Compact));
+  };
+
+  unsigned nrMismatches = 0;
+  for (auto it = results.begin(); it != results.end(); it++)
+  {
+    if (!golden.contains(it.key()))
+    {
+      logger.addMessage(QString("No golden result for %1").arg(it.key()),
+                        LoggingPriority::Warning);
+      continue;
+    }
+    auto goldenValue = golden[it.key()];
+    if (goldenValue != it.value())
+    {
+      logger.addMessage(QString("Mismatch in %1: expected %2 got %3")
+                            .arg(it.key())
+                            .arg(toString(goldenValue))
+                            .arg(toString(it.value())),
+                        LoggingPriority::Error);
+      nrMismatches++;
+    }
+  }
+  return nrMismatches;
+}
+
+int handleGoldenResults(const BenchmarkSettings &settings,
+                        const QJsonObject &      results,
+                        ILogger &                logger)
+{
+  if (!settings.writeGoldenFile.isEmpty() &&
+      !writeGoldenFile(settings.writeGoldenFile, results, logger))
+    return 1;
+
+  if (settings.goldenFile.isEmpty())
+    return 0;
+
+  auto golden = readGoldenFile(settings.goldenFile, logger);
+  if (!golden)
+    return 1;
+
+  auto nrMismatches = compareWithGolden(*golden, results, logger);
+  if (nrMismatches > 0)
+  {
+    logger.addMessage(QString("%1 results differ from the golden results").arg(nrMismatches),
+                      LoggingPriority::Error);
+    return 1;
+  }
+  logger.addMessage("All results match the golden results", LoggingPriority::Info);
+  return 0;
+}
+
+} // namespace cli
@@ -0,0 +1,81 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <common/ILogger.h>
+
+#include <QJsonObject>
+#include <QString>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace cli
+{
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+// Every benchmark case is repeated at least this often and until at least this much time was spent
+constexpr auto MIN_ITERATIONS = 3u;
+constexpr auto MAX_ITERATIONS = 1000u;
+constexpr auto MIN_CASE_TIME  = std::chrono::milliseconds(250);
+
+// True if a case that was started at caseStart and ran nrIterations times has to run again
+bool needsMoreIterations(size_t nrIterations, BenchmarkClock::time_point caseStart);
+
+double toMilliseconds(BenchmarkClock::duration duration);
+
+struct BenchmarkSettings
+{
+  // Only run the cases which contain this string in their name
+  QString filter;
+  // Write the JSON report to this file instead of stdout
+  QString outputFile;
+  // Compare the results with the golden results in this file
+  QString goldenFile;
+  // Write the results as the new golden results to this file
+  QString writeGoldenFile;
+};
+
+// The nearest rank percentiles (P50, P90, P99) and the mean and maximum of the values
+QJsonObject getPercentiles(std::vector<double> values);
+
+// Write the JSON report to the file (or stdout if the file name is empty)
+bool writeReport(const QJsonObject &report, const QString &fileName, ILogger &logger);
+
+/* Golden files contain the results of the benchmark cases (e.g. checksums of the output) that
+ * are known to be correct. An optimization must reproduce them bit exactly.
+ */
+std::optional<QJsonObject> readGoldenFile(const QString &fileName, ILogger &logger);
+bool writeGoldenFile(const QString &fileName, const QJsonObject &results, ILogger &logger);
+// Log every case whose result differs from the golden result. Cases without a golden result are
+// reported as warnings. Returns the number of mismatches.
+unsigned compareWithGolden(const QJsonObject &golden, const QJsonObject &results, ILogger &logger);
+
+// Write and/or check the golden results as given in the settings. Returns the exit code.
+int handleGoldenResults(const BenchmarkSettings &settings,
+                        const QJsonObject &      results,
+                        ILogger &                logger);
+
+} // namespace cli
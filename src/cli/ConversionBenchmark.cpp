@@ -0,0 +1,253 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "ConversionBenchmark.h"
+
+#include <common/ConsoleLogger.h>
+#include <video/YUVConversion.h>
+
+#include <QImage>
+#include <QJsonArray>
+#include <chrono>
+
+namespace cli
+{
+
+namespace
+{
+
+using ChromaInterpolation = video::yuv::ChromaInterpolation;
+using PixelFormatYUV      = video::yuv::PixelFormatYUV;
+using Subsampling         = video::yuv::Subsampling;
+using Clock               = BenchmarkClock;
+
+constexpr auto CONVERSION_REPORT_VERSION = 1;
+
+struct ConversionCase
+{
+  QString             name;
+  PixelFormatYUV      format;
+  Size                frameSize;
+  // Equal to the frame size if the conversion is not scaled
+  Size                outputSize;
+  ChromaInterpolation interpolation{ChromaInterpolation::NearestNeighbor};
+};
+
+QString getSizeName(const Size &size)
+{
+  return QString("%1x%2").arg(size.width).arg(size.height);
+}
+
+std::vector<ConversionCase> getConversionCases()
+{
+  const std::vector<Size> resolutions = {Size(720u, 576u),
+                                         Size(1280u, 720u),
+                                         Size(1920u, 1080u),
+                                         Size(3840u, 2160u),
+                                         Size(7680u, 4320u)};
+  const std::vector<std::pair<Subsampling, QString>> subsamplings = {
+      {Subsampling::YUV_420, "420"}, {Subsampling::YUV_422, "422"}, {Subsampling::YUV_444, "444"}};
+  const std::vector<std::pair<ChromaInterpolation, QString>> interpolations = {
+      {ChromaInterpolation::NearestNeighbor, "nearest"},
+      {ChromaInterpolation::Bilinear, "bilinear"}};
+
+  std::vector<ConversionCase> cases;
+  for (const auto &resolution : resolutions)
+  {
+    for (const auto &[subsampling, subsamplingName] : subsamplings)
+    {
+      for (const auto bitDepth : {8u, 10u})
+      {
+        ConversionCase conversionCase;
+        conversionCase.format     = PixelFormatYUV(subsampling, bitDepth);
+        conversionCase.frameSize  = resolution;
+        conversionCase.outputSize = resolution;
+        auto formatName           = QString("%1-%2bit").arg(subsamplingName).arg(bitDepth);
+
+        // 4:4:4 has no chroma upsampling
+        if (subsampling == Subsampling::YUV_444)
+        {
+          conversionCase.name = formatName + "-" + getSizeName(resolution);
+          cases.push_back(conversionCase);
+          continue;
+        }
+
+        for (const auto &[interpolation, interpolationName] : interpolations)
+        {
+          conversionCase.name =
+              formatName + "-" + interpolationName + "-" + getSizeName(resolution);
+          conversionCase.interpolation = interpolation;
+          cases.push_back(conversionCase);
+        }
+
+        // The fused upsampling and scaling of the software renderer
+        if (subsampling == Subsampling::YUV_420)
+        {
+          conversionCase.outputSize = Size(resolution.width / 2, resolution.height / 2);
+          conversionCase.name       = formatName + "-scaled-" + getSizeName(resolution) + "-to-" +
+                                getSizeName(conversionCase.outputSize);
+          cases.push_back(conversionCase);
+        }
+      }
+    }
+  }
+  return cases;
+}
+
+// Pseudo random samples (xorshift) with a fixed seed, so that every run converts the same data
+QByteArray createTestFrame(const PixelFormatYUV &format, const Size &frameSize)
+{
+  QByteArray data(int(format.bytesPerFrame(frameSize)), 0);
+
+  uint32_t   state    = 0x12345678;
+  const auto bitDepth = format.getBitsPerSample();
+  const auto maxValue = (1u << bitDepth) - 1;
+  auto       next     = [&state, maxValue]() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state & maxValue;
+  };
+
+  auto bytes = reinterpret_cast<unsigned char *>(data.data());
+  if (bitDepth > 8)
+  {
+    for (int i = 0; i + 1 < data.size(); i += 2)
+    {
+      auto value   = next();
+      bytes[i]     = uint8_t(value & 0xff);
+      bytes[i + 1] = uint8_t(value >> 8);
+    }
+  }
+  else
+  {
+    for (int i = 0; i < data.size(); i++)
+      bytes[i] = uint8_t(next());
+  }
+  return data;
+}
+
+// FNV-1a over the RGB values. The image is converted to RGB32 first so that the checksum does not
+// depend on the image format of the platform.
+QString getImageChecksum(const QImage &image)
+{
+  auto     rgbImage = image.convertToFormat(QImage::Format_RGB32);
+  uint64_t hash     = 0xcbf29ce484222325;
+  for (int y = 0; y < rgbImage.height(); y++)
+  {
+    auto line = rgbImage.constScanLine(y);
+    for (int i = 0; i < rgbImage.width() * 4; i++)
+    {
+      hash ^= line[i];
+      hash *= 0x100000001b3;
+    }
+  }
+  return QString("%1").arg(hash, 16, 16, QChar('0'));
+}
+
+void convert(const ConversionCase &conversionCase, const QByteArray &yuvData, QImage &image)
+{
+  if (conversionCase.outputSize == conversionCase.frameSize)
+    video::yuv::convertYUVToImage(yuvData,
+                                  image,
+                                  conversionCase.format,
+                                  conversionCase.frameSize,
+                                  conversionCase.interpolation);
+  else
+    video::yuv::convertYUVToImage(
+        yuvData, image, conversionCase.format, conversionCase.frameSize, conversionCase.outputSize);
+}
+
+} // namespace
+
+int runConversionBenchmark(const BenchmarkSettings &settings)
+{
+  ConsoleLogger logger;
+
+  QJsonArray  caseResults;
+  QJsonObject checksums;
+  for (const auto &conversionCase : getConversionCases())
+  {
+    if (!conversionCase.name.contains(settings.filter))
+      continue;
+
+    auto   yuvData = createTestFrame(conversionCase.format, conversionCase.frameSize);
+    QImage image;
+
+    // The first conversion is not timed. It also provides the checksum.
+    convert(conversionCase, yuvData, image);
+    auto checksum = getImageChecksum(image);
+
+    std::vector<double> timesMs;
+    auto                caseStart = Clock::now();
+    while (needsMoreIterations(timesMs.size(), caseStart))
+    {
+      auto start = Clock::now();
+      convert(conversionCase, yuvData, image);
+      timesMs.push_back(toMilliseconds(Clock::now() - start));
+    }
+
+    const auto &outputSize          = conversionCase.outputSize;
+    auto        timePercentiles     = getPercentiles(timesMs);
+    auto        medianMs            = timePercentiles["P50"].toDouble();
+    auto        nrOutputPixels      = double(outputSize.width) * double(outputSize.height);
+    auto        megaPixelsPerSecond = (medianMs > 0) ? nrOutputPixels / medianMs / 1000.0 : 0.0;
+
+    logger.addMessage(QString("%1: median %2 ms (%3 MPixel/s)")
+                          .arg(conversionCase.name)
+                          .arg(medianMs, 0, 'f', 3)
+                          .arg(megaPixelsPerSecond, 0, 'f', 1),
+                      LoggingPriority::Info);
+
+    QJsonObject caseResult;
+    caseResult["Name"]                = conversionCase.name;
+    caseResult["Format"]              = QString::fromStdString(conversionCase.format.getName());
+    caseResult["Width"]               = int(conversionCase.frameSize.width);
+    caseResult["Height"]              = int(conversionCase.frameSize.height);
+    caseResult["OutputWidth"]         = int(conversionCase.outputSize.width);
+    caseResult["OutputHeight"]        = int(conversionCase.outputSize.height);
+    caseResult["TimeMs"]              = timePercentiles;
+    caseResult["MegaPixelsPerSecond"] = megaPixelsPerSecond;
+    caseResult["Checksum"]            = checksum;
+    caseResults.append(caseResult);
+
+    checksums[conversionCase.name] = checksum;
+  }
+
+  if (caseResults.size() == 0)
+  {
+    logger.addMessage(QString("No conversion case matches %1").arg(settings.filter),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  QJsonObject report;
+  report["Version"] = CONVERSION_REPORT_VERSION;
+  report["Cases"]   = caseResults;
+  if (!writeReport(report, settings.outputFile, logger))
+    return 1;
+
+  return handleGoldenResults(settings, checksums, logger);
+}
+
+} // namespace cli
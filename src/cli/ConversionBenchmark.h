@@ -0,0 +1,37 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include "BenchmarkCommon.h"
+
+namespace cli
+{
+
+// Measure the conversion from YUV to RGB for all supported subsamplings, bit depths, chroma
+// interpolations and resolutions from SD to 8K on synthetic frames. The checksum of every
+// converted image can be written to or compared with a golden file, so that optimizations of the
+// conversion are verified to be bit exact. Returns the exit code for the application.
+int runConversionBenchmark(const BenchmarkSettings &settings);
+
+} // namespace cli
@@ -0,0 +1,120 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "HeadlessPlayback.h"
+
+#include "BenchmarkCommon.h"
+#include "HeadlessSink.h"
+
+#include <common/ConsoleLogger.h>
+#include <common/functions.h>
+
+#include <iostream>
+
+namespace cli
+{
+
+namespace
+{
+
+QString formatStage(const QString &name, const StageStatistics::Snapshot &statistics)
+{
+  return QString("%1: %2 frames %3 fps (working %4 ms, waiting %5 ms)")
+      .arg(name)
+      .arg(statistics.nrFrames)
+      .arg(statistics.getFPS(), 0, 'f', 1)
+      .arg(double(statistics.workUs) / 1000.0, 0, 'f', 1)
+      .arg(double(statistics.waitUs) / 1000.0, 0, 'f', 1);
+}
+
+void printSummary(const HeadlessSettings &    settings,
+                  const HeadlessSink::Result &result,
+                  const PlaybackController &  playbackController)
+{
+  auto playbackSeconds = toMilliseconds(result.playbackTime) / 1000.0;
+  auto fps = (playbackSeconds > 0) ? double(result.nrFramesTaken) / playbackSeconds : 0.0;
+
+  QStringList lines;
+  lines << QString("Headless playback of %1").arg(settings.manifestFile);
+  if (settings.framesPerSecond > 0)
+    lines << QString("Rate: %1 fps").arg(settings.framesPerSecond);
+  else
+    lines << "Rate: as fast as possible";
+  lines << QString("Frames: %1 taken, %2 dropped by the decoder")
+               .arg(result.nrFramesTaken)
+               .arg(result.nrFramesDropped);
+  lines << QString("Startup: %1 ms until the first frame")
+               .arg(toMilliseconds(result.startupTime), 0, 'f', 1);
+  lines << QString("Playback: %1 s (%2 fps)").arg(playbackSeconds, 0, 'f', 2).arg(fps, 0, 'f', 1);
+  if (settings.framesPerSecond > 0)
+  {
+    lines << QString("Stalls: %1 (total %2 ms, longest %3 ms)")
+                 .arg(result.nrStalls)
+                 .arg(toMilliseconds(result.totalStallTime), 0, 'f', 1)
+                 .arg(toMilliseconds(result.maxStallTime), 0, 'f', 1);
+    lines << QString("Presentation: deviation avg %1 ms max %2 ms")
+                 .arg(result.presentation.averageDeviationMs, 0, 'f', 1)
+                 .arg(result.presentation.maxDeviationMs, 0, 'f', 1);
+  }
+
+  lines << formatStage("Parser", playbackController.getParserStatistics());
+  for (const auto &decoder : playbackController.getDecoderStatistics())
+    lines << QString("Decoder %1: %2 frames %3 fps (waiting %4 ms) %5")
+                 .arg(decoder.instance)
+                 .arg(decoder.nrPictures)
+                 .arg(decoder.decodingFPS, 0, 'f', 1)
+                 .arg(double(decoder.totalWaitUs) / 1000.0, 0, 'f', 1)
+                 .arg(decoder.decoderInfo);
+  lines << formatStage("Conversion", playbackController.getConversionStatistics());
+
+  if (auto peakMemory = getPeakResidentMemoryBytes())
+    lines << QString("Peak memory: %1 MB").arg(double(*peakMemory) / 1024.0 / 1024.0, 0, 'f', 1);
+  else
+    lines << "Peak memory: not available";
+
+  std::cout << lines.join("\n").toStdString() << std::endl;
+}
+
+} // namespace
+
+int runHeadlessPlayback(const HeadlessSettings &settings, decoder::DecoderSettings decoderSettings)
+{
+  ConsoleLogger logger;
+
+  PlaybackController playbackController(&logger, decoderSettings);
+  playbackController.setConvertFramesToRGB(!settings.renderYUV);
+  if (!playbackController.openJsonManifestFile(settings.manifestFile))
+  {
+    logger.addMessage(QString("Unable to open manifest %1").arg(settings.manifestFile),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  HeadlessSink sink(&playbackController, settings);
+  auto         success = sink.run();
+
+  printSummary(settings, sink.getResult(), playbackController);
+  return success ? 0 : 1;
+}
+
+} // namespace cli
@@ -0,0 +1,49 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <decoder/DecoderSettings.h>
+
+#include <QString>
+
+namespace cli
+{
+
+struct HeadlessSettings
+{
+  QString manifestFile;
+  // Frames are taken with this rate. With 0, every frame is taken as soon as it is ready.
+  double   framesPerSecond{};
+  unsigned nrFrames{1000};
+  // Take the YUV frames without converting them to RGB (like the OpenGL renderer)
+  bool renderYUV{false};
+};
+
+// Play the manifest without a window. The frames are taken from the buffer by a sink that does
+// not display them. Once the given number of frames was taken, a summary of the throughput of
+// all stages, the stalls and the memory usage is printed. Returns the exit code for the
+// application.
+int runHeadlessPlayback(const HeadlessSettings &settings, decoder::DecoderSettings decoderSettings);
+
+} // namespace cli
@@ -0,0 +1,162 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "HeadlessSink.h"
+
+#include <QTimerEvent>
+#include <algorithm>
+#include <iostream>
+
+namespace cli
+{
+
+namespace
+{
+
+// The sink checks for new frames this often
+constexpr auto TICK_INTERVAL_MS = 1;
+// Playback is aborted if no frame arrives for this long
+constexpr auto STALL_TIMEOUT = std::chrono::seconds(10);
+
+} // namespace
+
+HeadlessSink::HeadlessSink(PlaybackController *playbackController,
+                           const HeadlessSettings &settings)
+    : playbackController(playbackController), settings(settings)
+{
+  this->result.frameIntervalsMs.reserve(settings.nrFrames);
+}
+
+bool HeadlessSink::run()
+{
+  this->startTime = Clock::now();
+  this->timer.start(TICK_INTERVAL_MS, Qt::PreciseTimer, this);
+  this->eventLoop.exec();
+  return !this->timedOut;
+}
+
+HeadlessSink::Result HeadlessSink::getResult() const
+{
+  auto result         = this->result;
+  result.presentation = this->presentationClock.getMetrics();
+  return result;
+}
+
+void HeadlessSink::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() != this->timer.timerId())
+    return QObject::timerEvent(event);
+
+  auto now = Clock::now();
+  if (this->settings.framesPerSecond > 0 && !this->curFrame.isNull())
+  {
+    auto nrDue = this->presentationClock.getNrFramesDue(now);
+    while (!this->isDone() && this->presentationClock.getNrFramesTaken() < nrDue)
+    {
+      if (!this->takeNextFrame(now))
+      {
+        this->onFrameUnavailable(now);
+        break;
+      }
+    }
+  }
+  else
+  {
+    while (!this->isDone() && this->takeNextFrame(now))
+      ;
+  }
+
+  if (this->isDone())
+  {
+    this->result.playbackTime = now - this->firstFrameTime;
+    this->quit();
+    return;
+  }
+
+  if (now - this->lastFrameTime > STALL_TIMEOUT && now - this->startTime > STALL_TIMEOUT)
+  {
+    std::cerr << "Error: No frame received for " << STALL_TIMEOUT.count() << " seconds"
+              << std::endl;
+    this->timedOut = true;
+    this->quit();
+  }
+}
+
+bool HeadlessSink::takeNextFrame(Clock::time_point now)
+{
+  auto                         segmentBuffer = this->playbackController->getSegmentBuffer();
+  SegmentBuffer::FrameIterator frame;
+  if (this->curFrame.isNull())
+    frame = segmentBuffer->getFirstFrameToDisplay();
+  else
+    frame = segmentBuffer->getNextFrameToDisplay(this->curFrame);
+  if (frame.isNull())
+    return false;
+
+  if (this->curFrame.isNull())
+  {
+    this->firstFrameTime     = now;
+    this->result.startupTime = now - this->startTime;
+    if (this->settings.framesPerSecond > 0)
+      this->presentationClock.setFramesPerSecond(this->settings.framesPerSecond, now);
+  }
+  else
+    this->result.frameIntervalsMs.push_back(
+        std::chrono::duration<double, std::milli>(now - this->lastFrameTime).count());
+
+  if (this->stallStart)
+  {
+    auto stallTime = now - *this->stallStart;
+    this->result.nrStalls++;
+    this->result.totalStallTime += stallTime;
+    this->result.maxStallTime = std::max(this->result.maxStallTime, stallTime);
+    this->stallStart.reset();
+  }
+
+  auto frameIndex = this->presentationClock.getNrFramesTaken();
+  this->presentationClock.onFrameTaken();
+  if (frame.frame->dropped)
+    this->result.nrFramesDropped++;
+  else if (this->settings.framesPerSecond > 0)
+    this->presentationClock.onFramePresented(frameIndex, now);
+
+  this->curFrame      = frame;
+  this->lastFrameTime = now;
+  this->result.nrFramesTaken++;
+  return true;
+}
+
+void HeadlessSink::onFrameUnavailable(Clock::time_point now)
+{
+  this->presentationClock.onFrameUnavailable(now);
+  if (!this->stallStart)
+    this->stallStart = now;
+}
+
+void HeadlessSink::quit()
+{
+  this->timer.stop();
+  this->eventLoop.quit();
+}
+
+} // namespace cli
@@ -0,0 +1,96 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include "HeadlessPlayback.h"
+
+#include <PlaybackController.h>
+#include <ui/PresentationClock.h>
+
+#include <QBasicTimer>
+#include <QEventLoop>
+#include <QObject>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace cli
+{
+
+/* Takes the frames from the segment buffer like the view does, but does not display them.
+ *
+ * Without a rate, every frame is taken as soon as it is ready. With a rate, the frames are taken
+ * when the presentation clock says they are due.
+ */
+class HeadlessSink : public QObject
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  HeadlessSink(PlaybackController *playbackController, const HeadlessSettings &settings);
+
+  // Runs until all frames were taken or no frame arrived for a while. Returns false in the
+  // latter case.
+  bool run();
+
+  struct Result
+  {
+    uint64_t                   nrFramesTaken{};
+    uint64_t                   nrFramesDropped{};
+    Clock::duration            startupTime{};
+    Clock::duration            playbackTime{};
+    unsigned                   nrStalls{};
+    Clock::duration            totalStallTime{};
+    Clock::duration            maxStallTime{};
+    PresentationClock::Metrics presentation;
+    // The time between two consecutive frames that were taken
+    std::vector<double> frameIntervalsMs;
+  };
+  Result getResult() const;
+
+private:
+  void timerEvent(QTimerEvent *event) override;
+  bool takeNextFrame(Clock::time_point now);
+  void onFrameUnavailable(Clock::time_point now);
+  bool isDone() const { return this->result.nrFramesTaken >= this->settings.nrFrames; }
+  void quit();
+
+  PlaybackController *playbackController{};
+  HeadlessSettings    settings;
+
+  QBasicTimer                  timer;
+  QEventLoop                   eventLoop;
+  SegmentBuffer::FrameIterator curFrame;
+  PresentationClock            presentationClock;
+
+  Clock::time_point                startTime;
+  Clock::time_point                firstFrameTime;
+  Clock::time_point                lastFrameTime;
+  std::optional<Clock::time_point> stallStart;
+  bool                             timedOut{false};
+
+  Result result;
+};
+
+} // namespace cli
@@ -0,0 +1,224 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include "LargeAccessUnitCheck.h"
+
+#include <cli/SyntheticBitstream.h>
+#include <common/ConsoleLogger.h>
+#include <decoder/decoderVVDec.h>
+#include <parser/SegmentIndex.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace cli
+{
+
+namespace
+{
+
+using parser::vvc::NalType;
+using synthetic::Picture;
+using synthetic::SliceType;
+
+// Low delay P pictures. The two large ones make the payload buffer grow twice: Once to twice the
+// initial size and then to eight times the initial size.
+std::vector<Picture> createPictures()
+{
+  const std::vector<int> sliceDataSizes = {1000,
+                                           500,
+                                           decoder::INITIAL_VVDEC_PAYLOAD_SIZE * 3 / 2,
+                                           500,
+                                           decoder::INITIAL_VVDEC_PAYLOAD_SIZE * 6,
+                                           500};
+
+  std::vector<Picture> pictures;
+  for (unsigned i = 0; i < sliceDataSizes.size(); i++)
+  {
+    Picture picture;
+    picture.poc           = i;
+    picture.sliceDataSize = sliceDataSizes[i];
+    if (i == 0)
+      picture.nalType = NalType::IDR_W_RADL;
+    else
+    {
+      picture.sliceType    = SliceType::P;
+      picture.referencesL0 = {-1};
+    }
+    pictures.push_back(picture);
+  }
+  return pictures;
+}
+
+// Stand-ins for the payload functions of libvvdec. Like the library, they use malloc and free.
+void allocPayload(vvdecAccessUnit *accessUnit, int payloadSize)
+{
+  accessUnit->payload     = static_cast<unsigned char *>(std::malloc(size_t(payloadSize)));
+  accessUnit->payloadSize = (accessUnit->payload != nullptr) ? payloadSize : 0;
+}
+
+void freePayload(vvdecAccessUnit *accessUnit)
+{
+  std::free(accessUnit->payload);
+  accessUnit->payload     = nullptr;
+  accessUnit->payloadSize = 0;
+}
+
+bool checkAccessUnitPositions(const parser::SegmentIndex & index,
+                              const std::vector<Picture> &pictures,
+                              const QByteArray &          data,
+                              ILogger &                   logger)
+{
+  if (index.accessUnits.size() != pictures.size())
+  {
+    logger.addMessage(QString("Expected %1 access units, the parser found %2")
+                          .arg(pictures.size())
+                          .arg(index.accessUnits.size()),
+                      LoggingPriority::Error);
+    return false;
+  }
+
+  uint64_t expectedOffset = 0;
+  for (size_t i = 0; i < index.accessUnits.size(); i++)
+  {
+    const auto &accessUnit = index.accessUnits[i];
+    if (accessUnit.offset != expectedOffset || accessUnit.poc != int(pictures[i].poc) ||
+        accessUnit.sizeBytes <= uint64_t(pictures[i].sliceDataSize))
+    {
+      logger.addMessage(QString("Access unit %1 (POC %2) at offset %3 with %4 bytes does not "
+                                "match the stream")
+                            .arg(i)
+                            .arg(accessUnit.poc)
+                            .arg(accessUnit.offset)
+                            .arg(accessUnit.sizeBytes),
+                        LoggingPriority::Error);
+      return false;
+    }
+    expectedOffset += accessUnit.sizeBytes;
+  }
+
+  if (expectedOffset != uint64_t(data.size()))
+  {
+    logger.addMessage(QString("The access units cover %1 of the %2 bytes of the stream")
+                          .arg(expectedOffset)
+                          .arg(data.size()),
+                      LoggingPriority::Error);
+    return false;
+  }
+  return true;
+}
+
+bool checkAccessUnitPayloads(const parser::SegmentIndex &index,
+                             const QByteArray &          data,
+                             ILogger &                   logger)
+{
+  decoder::LibraryFunctionsVVDec lib;
+  lib.vvdec_accessUnit_alloc_payload = allocPayload;
+  lib.vvdec_accessUnit_free_payload  = freePayload;
+
+  // Like the decoder, start with the initial payload buffer
+  vvdecAccessUnit accessUnit{};
+  if (!decoder::reserveAccessUnitPayload(lib, accessUnit, decoder::INITIAL_VVDEC_PAYLOAD_SIZE))
+  {
+    logger.addMessage("Error allocating the initial payload buffer", LoggingPriority::Error);
+    return false;
+  }
+
+  auto success     = true;
+  auto nrGrowths   = 0;
+  auto payloadSize = accessUnit.payloadSize;
+  for (const auto &indexAccessUnit : index.accessUnits)
+  {
+    const auto auData = data.mid(int(indexAccessUnit.offset), int(indexAccessUnit.sizeBytes));
+    if (!decoder::copyToAccessUnitPayload(lib, accessUnit, auData))
+    {
+      logger.addMessage(QString("Error allocating a payload buffer for %1 bytes")
+                            .arg(auData.size()),
+                        LoggingPriority::Error);
+      success = false;
+      break;
+    }
+    if (accessUnit.payloadSize != payloadSize)
+      nrGrowths++;
+    payloadSize = accessUnit.payloadSize;
+
+    if (accessUnit.payloadUsedSize != auData.size() ||
+        std::memcmp(accessUnit.payload, auData.constData(), size_t(auData.size())) != 0)
+    {
+      logger.addMessage(QString("The payload of the access unit with POC %1 (%2 bytes) differs "
+                                "from the stream")
+                            .arg(indexAccessUnit.poc)
+                            .arg(auData.size()),
+                        LoggingPriority::Error);
+      success = false;
+      break;
+    }
+  }
+  freePayload(&accessUnit);
+
+  if (success && nrGrowths < 2)
+  {
+    logger.addMessage(QString("The payload buffer grew %1 times instead of twice").arg(nrGrowths),
+                      LoggingPriority::Error);
+    return false;
+  }
+  return success;
+}
+
+} // namespace
+
+int runLargeAccessUnitCheck()
+{
+  ConsoleLogger logger;
+
+  const auto pictures = createPictures();
+  const auto data     = synthetic::createStream({}, pictures);
+
+  std::vector<int> nalsWithErrors;
+  const auto       index = parser::buildSegmentIndex(data, &nalsWithErrors);
+  if (!nalsWithErrors.empty())
+  {
+    logger.addMessage(QString("Error parsing %1 NAL units of the stream")
+                          .arg(nalsWithErrors.size()),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  if (!checkAccessUnitPositions(index, pictures, data, logger) ||
+      !checkAccessUnitPayloads(index, data, logger))
+    return 1;
+
+  uint64_t largestSize = 0;
+  for (const auto &accessUnit : index.accessUnits)
+    largestSize = std::max(largestSize, accessUnit.sizeBytes);
+
+  logger.addMessage(QString("All %1 access units (up to %2 bytes) of the %3 byte stream were "
+                            "copied unchanged")
+                        .arg(index.accessUnits.size())
+                        .arg(largestSize)
+                        .arg(data.size()),
+                    LoggingPriority::Info);
+  return 0;
+}
+
+} // namespace cli
@@ -0,0 +1,210 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "ParserBenchmark.h"
+
+#include <common/AllocationCounter.h>
+#include <common/ConsoleLogger.h>
+#include <common/functions.h>
+#include <parser/SegmentIndex.h>
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <chrono>
+
+namespace cli
+{
+
+namespace
+{
+
+using Clock = BenchmarkClock;
+
+constexpr auto PARSER_REPORT_VERSION = 1;
+
+const QStringList ANNEX_B_FILE_PATTERNS = {"*.vvc", "*.266", "*.bin"};
+
+unsigned countNalUnits(const QByteArray &data)
+{
+  unsigned nrNalUnits = 0;
+  auto     nalStart   = findNextNalInData(data, 0);
+  while (nalStart)
+  {
+    nrNalUnits++;
+    nalStart = findNextNalInData(data, *nalStart + 3);
+  }
+  return nrNalUnits;
+}
+
+// The golden result of a file. These must not change when the parser is optimized.
+QJsonObject getAccessUnitResult(const parser::SegmentIndex &index, unsigned nrNalUnits)
+{
+  QJsonArray pocs;
+  QJsonArray sizes;
+  for (const auto &accessUnit : index.accessUnits)
+  {
+    pocs.append(accessUnit.poc);
+    sizes.append(qint64(accessUnit.sizeBytes));
+  }
+
+  QJsonObject result;
+  result["NalUnits"]    = int(nrNalUnits);
+  result["AccessUnits"] = int(index.accessUnits.size());
+  result["POCs"]        = pocs;
+  result["Sizes"]       = sizes;
+  return result;
+}
+
+} // namespace
+
+int runParserBenchmark(const QString &directory, const BenchmarkSettings &settings)
+{
+  ConsoleLogger logger;
+
+  QDir dir(directory);
+  if (!dir.exists())
+  {
+    logger.addMessage(QString("Directory %1 does not exist").arg(directory),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  QJsonArray  fileResults;
+  QJsonObject accessUnitResults;
+  double      totalTimeSeconds = 0.0;
+  uint64_t    totalBytes       = 0;
+  uint64_t    totalNalUnits    = 0;
+  uint64_t    totalAllocations = 0;
+  unsigned    nrErrors         = 0;
+  for (const auto &fileName : dir.entryList(ANNEX_B_FILE_PATTERNS, QDir::Files, QDir::Name))
+  {
+    if (!fileName.contains(settings.filter))
+      continue;
+
+    QFile file(dir.filePath(fileName));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+      logger.addMessage(QString("Error reading file %1").arg(fileName), LoggingPriority::Error);
+      nrErrors++;
+      continue;
+    }
+    const auto data       = file.readAll();
+    const auto nrNalUnits = countNalUnits(data);
+    if (nrNalUnits == 0)
+    {
+      logger.addMessage(QString("No NAL units found in %1").arg(fileName),
+                        LoggingPriority::Warning);
+      continue;
+    }
+
+    // The first parse is not timed. It also provides the access units and the parsing errors.
+    std::vector<int> nalsWithErrors;
+    auto             index = parser::buildSegmentIndex(data, &nalsWithErrors);
+    if (!nalsWithErrors.empty())
+    {
+      logger.addMessage(QString("Error parsing %1 NAL units in %2")
+                            .arg(nalsWithErrors.size())
+                            .arg(fileName),
+                        LoggingPriority::Error);
+      nrErrors++;
+    }
+
+    std::vector<double> timesMs;
+    uint64_t            nrAllocations = 0;
+    auto                fileStart     = Clock::now();
+    while (needsMoreIterations(timesMs.size(), fileStart))
+    {
+      auto allocationsBefore = allocation::getNumberAllocationsOfCurrentThread();
+      auto start             = Clock::now();
+      parser::buildSegmentIndex(data);
+      timesMs.push_back(toMilliseconds(Clock::now() - start));
+      nrAllocations += allocation::getNumberAllocationsOfCurrentThread() - allocationsBefore;
+    }
+
+    const auto nrIterations    = timesMs.size();
+    auto       timePercentiles = getPercentiles(timesMs);
+    auto       medianSeconds   = timePercentiles["P50"].toDouble() / 1000.0;
+    auto       nalsPerSecond   = (medianSeconds > 0) ? nrNalUnits / medianSeconds : 0.0;
+    auto       megaBytesPerSecond =
+        (medianSeconds > 0) ? double(data.size()) / medianSeconds / 1000000.0 : 0.0;
+    auto allocationsPerNal = double(nrAllocations) / double(nrIterations) / double(nrNalUnits);
+
+    auto message = QString("%1: %2 NAL/s, %3 MB/s")
+                       .arg(fileName)
+                       .arg(nalsPerSecond, 0, 'f', 0)
+                       .arg(megaBytesPerSecond, 0, 'f', 1);
+    if (allocation::isCountingAllocations())
+      message += QString(", %1 allocations per NAL").arg(allocationsPerNal, 0, 'f', 1);
+    logger.addMessage(message, LoggingPriority::Info);
+
+    totalTimeSeconds += medianSeconds;
+    totalBytes += uint64_t(data.size());
+    totalNalUnits += nrNalUnits;
+    totalAllocations += nrAllocations / nrIterations;
+
+    QJsonObject fileResult;
+    fileResult["File"]               = fileName;
+    fileResult["Bytes"]              = qint64(data.size());
+    fileResult["NalUnits"]           = int(nrNalUnits);
+    fileResult["AccessUnits"]        = int(index.accessUnits.size());
+    fileResult["NalUnitsWithErrors"] = int(nalsWithErrors.size());
+    fileResult["TimeMs"]             = timePercentiles;
+    fileResult["NalUnitsPerSecond"]  = nalsPerSecond;
+    fileResult["MegaBytesPerSecond"] = megaBytesPerSecond;
+    if (allocation::isCountingAllocations())
+      fileResult["AllocationsPerNal"] = allocationsPerNal;
+    fileResults.append(fileResult);
+
+    accessUnitResults[fileName] = getAccessUnitResult(index, nrNalUnits);
+  }
+
+  if (fileResults.size() == 0)
+  {
+    logger.addMessage(QString("No annex B files found in %1").arg(directory),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  QJsonObject total;
+  total["Bytes"]              = qint64(totalBytes);
+  total["NalUnits"]           = qint64(totalNalUnits);
+  total["TimeMs"]             = totalTimeSeconds * 1000.0;
+  total["NalUnitsPerSecond"]  = (totalTimeSeconds > 0) ? totalNalUnits / totalTimeSeconds : 0.0;
+  total["MegaBytesPerSecond"] =
+      (totalTimeSeconds > 0) ? double(totalBytes) / totalTimeSeconds / 1000000.0 : 0.0;
+  if (allocation::isCountingAllocations())
+    total["AllocationsPerNal"] = double(totalAllocations) / double(totalNalUnits);
+
+  QJsonObject report;
+  report["Version"] = PARSER_REPORT_VERSION;
+  report["Files"]   = fileResults;
+  report["Total"]   = total;
+  if (!writeReport(report, settings.outputFile, logger))
+    return 1;
+
+  auto returnCode = handleGoldenResults(settings, accessUnitResults, logger);
+  return (nrErrors > 0) ? 1 : returnCode;
+}
+
+} // namespace cli
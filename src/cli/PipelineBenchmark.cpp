@@ -0,0 +1,246 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "PipelineBenchmark.h"
+
+#include "BenchmarkCommon.h"
+#include "HeadlessSink.h"
+
+#include <common/ConsoleLogger.h>
+#include <common/functions.h>
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+namespace cli
+{
+
+namespace
+{
+
+constexpr auto BENCHMARK_REPORT_VERSION = 1;
+
+QJsonObject stageToJSON(const StageStatistics::Snapshot &statistics)
+{
+  QJsonObject stage;
+  stage["NrFrames"] = qint64(statistics.nrFrames);
+  stage["FPS"]      = statistics.getFPS();
+  stage["WorkMs"]   = double(statistics.workUs) / 1000.0;
+  stage["WaitMs"]   = double(statistics.waitUs) / 1000.0;
+  return stage;
+}
+
+QJsonObject downloadToJSON(const FileDownloader::Statistics &statistics)
+{
+  QJsonObject download;
+  download["NrSegments"] = int(statistics.nrSegments);
+  download["NrBytes"]    = qint64(statistics.nrBytes);
+  download["DurationMs"] = double(statistics.durationUs) / 1000.0;
+  if (statistics.durationUs > 0)
+    download["MBPerSecond"] = double(statistics.nrBytes) / double(statistics.durationUs);
+  return download;
+}
+
+// The combined decoding speed of all decoder instances and the average speed of one instance
+QJsonObject decoderThroughputToJSON(const std::vector<DecoderStatistics::Snapshot> &snapshots)
+{
+  double totalFPS = 0.0;
+  for (const auto &snapshot : snapshots)
+    totalFPS += snapshot.decodingFPS;
+
+  QJsonObject throughput;
+  throughput["NrInstances"] = int(snapshots.size());
+  throughput["TotalFPS"]    = totalFPS;
+  if (!snapshots.empty())
+    throughput["FPSPerInstance"] = totalFPS / double(snapshots.size());
+  return throughput;
+}
+
+QJsonArray decodersToJSON(const std::vector<DecoderStatistics::Snapshot> &snapshots)
+{
+  QJsonArray decoders;
+  for (const auto &snapshot : snapshots)
+  {
+    std::vector<double> pictureLatenciesMs;
+    for (const auto &picture : snapshot.pictures)
+      pictureLatenciesMs.push_back(double(picture.latencyUs) / 1000.0);
+    std::vector<double> segmentDecodeTimesMs;
+    for (const auto &segment : snapshot.segments)
+      segmentDecodeTimesMs.push_back(double(segment.decodeUs) / 1000.0);
+
+    QJsonObject decoder;
+    decoder["Instance"]         = int(snapshot.instance);
+    decoder["DecoderInfo"]      = snapshot.decoderInfo;
+    decoder["NrPictures"]       = qint64(snapshot.nrPictures);
+    decoder["FPS"]              = snapshot.decodingFPS;
+    decoder["WaitMs"]           = double(snapshot.totalWaitUs) / 1000.0;
+    decoder["PictureLatencyMs"] = getPercentiles(pictureLatenciesMs);
+    decoder["SegmentDecodeMs"]  = getPercentiles(segmentDecodeTimesMs);
+    decoders.append(decoder);
+  }
+  return decoders;
+}
+
+bool hasRemoteSegments(const ManifestFile &manifest)
+{
+  for (unsigned rendition = 0; rendition < manifest.getRenditionInfos().size(); rendition++)
+  {
+    if (!isURLLocalFile(manifest.getSegmentInfo(0, rendition).downloadUrl))
+      return true;
+  }
+  return false;
+}
+
+// Run the benchmark once and return the report. Success is false if the playback failed. The peak
+// memory is the peak of the whole process, so it is only meaningful for the first run in it.
+QJsonObject runBenchmark(const HeadlessSettings &        settings,
+                         const decoder::DecoderSettings &decoderSettings,
+                         bool                            reportPeakMemory,
+                         ILogger &                       logger,
+                         bool &                          success)
+{
+  auto cpuTimeStart = getProcessCPUTimeSeconds();
+  auto wallStart    = HeadlessSink::Clock::now();
+
+  PlaybackController playbackController(&logger, decoderSettings);
+  playbackController.setConvertFramesToRGB(!settings.renderYUV);
+  if (!playbackController.openJsonManifestFile(settings.manifestFile))
+  {
+    logger.addMessage(QString("Unable to open manifest %1").arg(settings.manifestFile),
+                      LoggingPriority::Error);
+    success = false;
+    return {};
+  }
+  if (hasRemoteSegments(*playbackController.getManifest()))
+    logger.addMessage("The manifest contains remote segments. The results depend on the network.",
+                      LoggingPriority::Warning);
+
+  HeadlessSink sink(&playbackController, settings);
+  success = sink.run();
+
+  auto wallTime   = HeadlessSink::Clock::now() - wallStart;
+  auto cpuTimeEnd = getProcessCPUTimeSeconds();
+  auto result     = sink.getResult();
+
+  QJsonObject settingsObject;
+  settingsObject["NrFrames"]        = int(settings.nrFrames);
+  settingsObject["FramesPerSecond"] = settings.framesPerSecond;
+  settingsObject["RenderYUV"]       = settings.renderYUV;
+  settingsObject["DecoderSettings"] = decoderSettings.toString();
+
+  auto playbackMs = toMilliseconds(result.playbackTime);
+
+  QJsonObject sinkObject;
+  sinkObject["NrFrames"]        = qint64(result.nrFramesTaken);
+  sinkObject["NrFramesDropped"] = qint64(result.nrFramesDropped);
+  sinkObject["StartupMs"]       = toMilliseconds(result.startupTime);
+  sinkObject["PlaybackMs"]      = playbackMs;
+  if (playbackMs > 0)
+    sinkObject["FPS"] = double(result.nrFramesTaken) * 1000.0 / playbackMs;
+  sinkObject["FrameIntervalMs"] = getPercentiles(result.frameIntervalsMs);
+  sinkObject["NrStalls"]        = int(result.nrStalls);
+  sinkObject["StallMs"]         = toMilliseconds(result.totalStallTime);
+
+  auto decoderStatistics = playbackController.getDecoderStatistics();
+
+  QJsonObject report;
+  report["Version"]    = BENCHMARK_REPORT_VERSION;
+  report["Manifest"]   = settings.manifestFile;
+  report["Settings"]   = settingsObject;
+  report["Success"]    = success;
+  report["WallTimeMs"] = toMilliseconds(wallTime);
+  if (cpuTimeStart && cpuTimeEnd)
+    report["CPUTimeMs"] = (*cpuTimeEnd - *cpuTimeStart) * 1000.0;
+  if (auto peakMemory = getPeakResidentMemoryBytes(); peakMemory && reportPeakMemory)
+    report["PeakMemoryBytes"] = qint64(*peakMemory);
+  report["Sink"]              = sinkObject;
+  report["Download"]          = downloadToJSON(playbackController.getDownloadStatistics());
+  report["Parser"]            = stageToJSON(playbackController.getParserStatistics());
+  report["Decoders"]          = decodersToJSON(decoderStatistics);
+  report["DecoderThroughput"] = decoderThroughputToJSON(decoderStatistics);
+  report["Conversion"]        = stageToJSON(playbackController.getConversionStatistics());
+  return report;
+}
+
+} // namespace
+
+int runPipelineBenchmark(const HeadlessSettings & settings,
+                         decoder::DecoderSettings decoderSettings,
+                         QString                  outputFile,
+                         std::vector<int>         instanceSweep)
+{
+  ConsoleLogger logger;
+
+  if (instanceSweep.empty())
+  {
+    bool success{};
+    auto report = runBenchmark(settings, decoderSettings, true, logger, success);
+    if (report.isEmpty() || !writeReport(report, outputFile, logger))
+      return 1;
+    return success ? 0 : 1;
+  }
+
+  // Run the whole benchmark once for every number of decoder instances. All runs share the process,
+  // so its peak memory would always include the earlier runs and is not reported.
+  const auto peakMemoryNote = QString("Peak memory is only reported for single configuration "
+                                      "runs. Run the benchmark once per instance count to get it.");
+  logger.addMessage(peakMemoryNote, LoggingPriority::Info);
+
+  QJsonArray runs;
+  bool       allSucceeded = true;
+  for (const auto nrInstances : instanceSweep)
+  {
+    logger.addMessage(QString("Running benchmark with %1 decoder instances").arg(nrInstances),
+                      LoggingPriority::Info);
+    decoderSettings.instances = nrInstances;
+
+    bool success{};
+    auto report = runBenchmark(settings, decoderSettings, false, logger, success);
+    if (report.isEmpty())
+      return 1;
+    allSucceeded = allSucceeded && success;
+
+    const auto throughput = report.value("DecoderThroughput").toObject();
+
+    QJsonObject run;
+    run["Instances"]      = nrInstances;
+    run["NrDecoders"]     = throughput.value("NrInstances");
+    run["SinkFPS"]        = report.value("Sink").toObject().value("FPS");
+    run["DecoderFPS"]     = throughput.value("TotalFPS");
+    run["FPSPerInstance"] = throughput.value("FPSPerInstance");
+    run["Report"]         = report;
+    runs.append(run);
+  }
+
+  QJsonObject sweepReport;
+  sweepReport["Version"]       = BENCHMARK_REPORT_VERSION;
+  sweepReport["Manifest"]      = settings.manifestFile;
+  sweepReport["InstanceSweep"] = runs;
+  sweepReport["PeakMemory"]    = peakMemoryNote;
+  if (!writeReport(sweepReport, outputFile, logger))
+    return 1;
+
+  return allSucceeded ? 0 : 1;
+}
+
+} // namespace cli
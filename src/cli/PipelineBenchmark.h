@@ -0,0 +1,44 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include "HeadlessPlayback.h"
+
+#include <vector>
+
+namespace cli
+{
+
+// Play a local manifest headless and write a JSON report with the throughput of every stage of
+// the pipeline, latency percentiles, the CPU time and the peak memory usage to the output file (or
+// stdout if no file is given). The reports of different builds can be compared to find
+// regressions. If an instance sweep is given, the benchmark is run once for every number of
+// decoder instances in it and the report lists the decoding speed of every run, so that the scaling
+// with the number of instances can be seen. Returns the exit code for the application.
+int runPipelineBenchmark(const HeadlessSettings & settings,
+                         decoder::DecoderSettings decoderSettings,
+                         QString                  outputFile,
+                         std::vector<int>         instanceSweep = {});
+
+} // namespace cli
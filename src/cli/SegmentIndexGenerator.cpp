@@ -0,0 +1,111 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "SegmentIndexGenerator.h"
+
+#include <ManifestFile.h>
+#include <common/ConsoleLogger.h>
+#include <common/functions.h>
+#include <parser/SegmentIndex.h>
+
+#include <QFile>
+
+namespace cli
+{
+
+int generateSegmentIndexFiles(QString manifestFile)
+{
+  ConsoleLogger logger;
+
+  ManifestFile manifest(&logger);
+  if (!manifest.openJsonManifestFile(manifestFile))
+  {
+    logger.addMessage(QString("Unable to open manifest %1").arg(manifestFile),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  const auto nrRenditions = unsigned(manifest.getRenditionInfos().size());
+  const auto nrSegments   = manifest.getNumberSegments();
+
+  auto parameterSetCache = std::make_shared<parser::vvc::ParameterSetCache>();
+
+  unsigned nrIndexFilesWritten = 0;
+  unsigned nrErrors            = 0;
+  for (unsigned rendition = 0; rendition < nrRenditions; rendition++)
+  {
+    for (unsigned segment = 0; segment < nrSegments; segment++)
+    {
+      auto segmentInfo = manifest.getSegmentInfo(segment, rendition);
+      auto url         = segmentInfo.downloadUrl;
+      if (!isURLLocalFile(url))
+      {
+        logger.addMessage(QString("Skipping remote segment %1").arg(url), LoggingPriority::Warning);
+        continue;
+      }
+
+      QFile segmentFile(url);
+      if (!segmentFile.open(QIODevice::ReadOnly))
+      {
+        logger.addMessage(QString("Error reading file %1").arg(url), LoggingPriority::Error);
+        nrErrors++;
+        continue;
+      }
+
+      std::vector<int> nalsWithErrors;
+      auto             index = parser::buildSegmentIndex(
+          segmentFile.readAll(), &nalsWithErrors, nullptr, parameterSetCache);
+      if (!nalsWithErrors.empty())
+      {
+        logger.addMessage(QString("Error parsing %1 NAL units in %2. No index written.")
+                              .arg(nalsWithErrors.size())
+                              .arg(url),
+                          LoggingPriority::Error);
+        nrErrors++;
+        continue;
+      }
+
+      auto indexFileName = parser::getSegmentIndexFileName(url);
+      if (!parser::writeSegmentIndexFile(indexFileName, index))
+      {
+        logger.addMessage(QString("Error writing index file %1").arg(indexFileName),
+                          LoggingPriority::Error);
+        nrErrors++;
+        continue;
+      }
+
+      logger.addMessage(
+          QString("Wrote %1 (%2 AUs)").arg(indexFileName).arg(index.accessUnits.size()),
+          LoggingPriority::Info);
+      nrIndexFilesWritten++;
+    }
+  }
+
+  logger.addMessage(QString("Wrote %1 index files with %2 errors")
+                        .arg(nrIndexFilesWritten)
+                        .arg(nrErrors),
+                    LoggingPriority::Info);
+  return nrErrors == 0 ? 0 : 1;
+}
+
+} // namespace cli
@@ -0,0 +1,491 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "SyntheticBitstream.h"
+
+#include <common/ConsoleLogger.h>
+
+#include <QDir>
+#include <QFile>
+
+namespace cli::synthetic
+{
+
+using parser::vvc::isIRAP;
+using parser::vvc::NalType;
+
+namespace
+{
+
+// All streams use the same small picture format: 64x64 luma samples, 4:2:0, 10 bit and a CTU size
+// of 32. So every picture consists of 2x2 CTUs in a single slice.
+constexpr unsigned PICTURE_SIZE     = 64;
+constexpr unsigned BIT_DEPTH_MINUS8 = 2;
+
+// Writes the bits of an RBSP. This is the counterpart of the reading functions of the
+// SubByteReader without the emulation prevention (which is added to the whole NAL unit).
+class BitWriter
+{
+public:
+  void writeFlag(bool flag)
+  {
+    if (this->nrBitsInLastByte == 0)
+      this->data.append(char(0));
+    if (flag)
+      this->data[this->data.size() - 1] |= char(0x80 >> this->nrBitsInLastByte);
+    this->nrBitsInLastByte = (this->nrBitsInLastByte + 1) % 8;
+  }
+  void writeBits(uint64_t value, unsigned nrBits)
+  {
+    for (unsigned i = nrBits; i > 0; i--)
+      this->writeFlag((value >> (i - 1)) & 1);
+  }
+  void writeUEV(uint64_t value)
+  {
+    const auto codeNum    = value + 1;
+    unsigned   nrZeroBits = 0;
+    while ((codeNum >> (nrZeroBits + 1)) > 0)
+      nrZeroBits++;
+    this->writeBits(0, nrZeroBits);
+    this->writeBits(codeNum, nrZeroBits + 1);
+  }
+  void writeSEV(int64_t value)
+  {
+    this->writeUEV(value > 0 ? uint64_t(2 * value - 1) : uint64_t(-2 * value));
+  }
+  void writeZeroBitsUntilByteAligned()
+  {
+    while (this->nrBitsInLastByte != 0)
+      this->writeFlag(false);
+  }
+  // rbsp_trailing_bits() and byte_alignment() are both a one followed by zeros
+  void writeTrailingBits()
+  {
+    this->writeFlag(true);
+    this->writeZeroBitsUntilByteAligned();
+  }
+  void writeBytes(const QByteArray &bytes)
+  {
+    this->writeZeroBitsUntilByteAligned();
+    this->data.append(bytes);
+  }
+
+  QByteArray data;
+
+private:
+  unsigned nrBitsInLastByte{0};
+};
+
+QByteArray createSPS(const StreamSettings &settings)
+{
+  const auto maxSublayersMinus1 = settings.maxSublayers - 1;
+
+  BitWriter writer;
+  writer.writeBits(0, 4);                  // sps_seq_parameter_set_id
+  writer.writeBits(0, 4);                  // sps_video_parameter_set_id
+  writer.writeBits(maxSublayersMinus1, 3); // sps_max_sublayers_minus1
+  writer.writeBits(1, 2);                  // sps_chroma_format_idc (4:2:0)
+  writer.writeBits(0, 2);                  // sps_log2_ctu_size_minus5
+  writer.writeFlag(true);                  // sps_ptl_dpb_hrd_params_present_flag
+
+  // profile_tier_level
+  writer.writeBits(1, 7);  // general_profile_idc (Main 10)
+  writer.writeFlag(false); // general_tier_flag
+  writer.writeBits(35, 8); // general_level_idc (2.1)
+  writer.writeFlag(true);  // ptl_frame_only_constraint_flag
+  writer.writeFlag(false); // ptl_multilayer_enabled_flag
+  writer.writeFlag(false); // gci_present_flag
+  writer.writeZeroBitsUntilByteAligned();
+  for (unsigned i = 0; i < maxSublayersMinus1; i++)
+    writer.writeFlag(false); // ptl_sublayer_level_present_flag
+  writer.writeZeroBitsUntilByteAligned();
+  writer.writeBits(0, 8); // ptl_num_sub_profiles
+
+  writer.writeFlag(false);                         // sps_gdr_enabled_flag
+  writer.writeFlag(false);                         // sps_ref_pic_resampling_enabled_flag
+  writer.writeUEV(PICTURE_SIZE);                   // sps_pic_width_max_in_luma_samples
+  writer.writeUEV(PICTURE_SIZE);                   // sps_pic_height_max_in_luma_samples
+  writer.writeFlag(false);                         // sps_conformance_window_flag
+  writer.writeFlag(false);                         // sps_subpic_info_present_flag
+  writer.writeUEV(BIT_DEPTH_MINUS8);               // sps_bitdepth_minus8
+  writer.writeFlag(false);                         // sps_entropy_coding_sync_enabled_flag
+  writer.writeFlag(false);                         // sps_entry_point_offsets_present_flag
+  writer.writeBits(settings.log2MaxPocLsb - 4, 4); // sps_log2_max_pic_order_cnt_lsb_minus4
+  writer.writeFlag(false);                         // sps_poc_msb_cycle_flag
+  writer.writeBits(0, 2);                          // sps_num_extra_ph_bytes
+  writer.writeBits(0, 2);                          // sps_num_extra_sh_bytes
+  if (maxSublayersMinus1 > 0)
+    writer.writeFlag(false); // sps_sublayer_dpb_params_flag
+
+  // dpb_parameters (only for the highest sublayer)
+  writer.writeUEV(5);                  // dpb_max_dec_pic_buffering_minus1
+  writer.writeUEV(maxSublayersMinus1); // dpb_max_num_reorder_pics
+  writer.writeUEV(0);                  // dpb_max_latency_increase_plus1
+
+  writer.writeUEV(0);      // sps_log2_min_luma_coding_block_size_minus2
+  writer.writeFlag(false); // sps_partition_constraints_override_enabled_flag
+  writer.writeUEV(1);      // sps_log2_diff_min_qt_min_cb_intra_slice_luma
+  writer.writeUEV(0);      // sps_max_mtt_hierarchy_depth_intra_slice_luma
+  writer.writeFlag(false); // sps_qtbtt_dual_tree_intra_flag
+  writer.writeUEV(1);      // sps_log2_diff_min_qt_min_cb_inter_slice
+  writer.writeUEV(0);      // sps_max_mtt_hierarchy_depth_inter_slice
+  writer.writeFlag(false); // sps_transform_skip_enabled_flag
+  writer.writeFlag(false); // sps_mts_enabled_flag
+  writer.writeFlag(false); // sps_lfnst_enabled_flag
+  writer.writeFlag(false); // sps_joint_cbcr_enabled_flag
+  writer.writeFlag(true);  // sps_same_qp_table_for_chroma_flag
+  writer.writeSEV(0);      // sps_qp_table_start_minus26
+  writer.writeUEV(0);      // sps_num_points_in_qp_table_minus1
+  writer.writeUEV(0);      // sps_delta_qp_in_val_minus1
+  writer.writeUEV(0);      // sps_delta_qp_diff_val
+  writer.writeFlag(false); // sps_sao_enabled_flag
+  writer.writeFlag(false); // sps_alf_enabled_flag
+  writer.writeFlag(false); // sps_lmcs_enabled_flag
+  writer.writeFlag(false); // sps_weighted_pred_flag
+  writer.writeFlag(false); // sps_weighted_bipred_flag
+  writer.writeFlag(false); // sps_long_term_ref_pics_flag
+  writer.writeFlag(false); // sps_idr_rpl_present_flag
+  writer.writeFlag(true);  // sps_rpl1_same_as_rpl0_flag
+  writer.writeUEV(0);      // sps_num_ref_pic_lists
+  writer.writeFlag(false); // sps_ref_wraparound_enabled_flag
+  writer.writeFlag(false); // sps_temporal_mvp_enabled_flag
+  writer.writeFlag(false); // sps_amvr_enabled_flag
+  writer.writeFlag(false); // sps_bdof_enabled_flag
+  writer.writeFlag(false); // sps_smvd_enabled_flag
+  writer.writeFlag(false); // sps_dmvr_enabled_flag
+  writer.writeFlag(false); // sps_mmvd_enabled_flag
+  writer.writeUEV(0);      // sps_six_minus_max_num_merge_cand
+  writer.writeFlag(false); // sps_sbt_enabled_flag
+  writer.writeFlag(false); // sps_affine_enabled_flag
+  writer.writeFlag(false); // sps_bcw_enabled_flag
+  writer.writeFlag(false); // sps_ciip_enabled_flag
+  writer.writeFlag(false); // sps_gpm_enabled_flag
+  writer.writeUEV(0);      // sps_log2_parallel_merge_level_minus2
+  writer.writeFlag(false); // sps_isp_enabled_flag
+  writer.writeFlag(false); // sps_mrl_enabled_flag
+  writer.writeFlag(false); // sps_mip_enabled_flag
+  writer.writeFlag(false); // sps_cclm_enabled_flag
+  writer.writeFlag(true);  // sps_chroma_horizontal_collocated_flag
+  writer.writeFlag(false); // sps_chroma_vertical_collocated_flag
+  writer.writeFlag(false); // sps_palette_enabled_flag
+  writer.writeFlag(false); // sps_ibc_enabled_flag
+  writer.writeFlag(false); // sps_ladf_enabled_flag
+  writer.writeFlag(false); // sps_explicit_scaling_list_enabled_flag
+  writer.writeFlag(false); // sps_dep_quant_enabled_flag
+  writer.writeFlag(false); // sps_sign_data_hiding_enabled_flag
+  writer.writeFlag(false); // sps_virtual_boundaries_enabled_flag
+  writer.writeFlag(false); // sps_timing_hrd_params_present_flag
+  writer.writeFlag(false); // sps_field_seq_flag
+  writer.writeFlag(false); // sps_vui_parameters_present_flag
+  writer.writeFlag(false); // sps_extension_flag
+  writer.writeTrailingBits();
+  return writer.data;
+}
+
+QByteArray createPPS()
+{
+  BitWriter writer;
+  writer.writeBits(0, 6);        // pps_pic_parameter_set_id
+  writer.writeBits(0, 4);        // pps_seq_parameter_set_id
+  writer.writeFlag(false);       // pps_mixed_nalu_types_in_pic_flag
+  writer.writeUEV(PICTURE_SIZE); // pps_pic_width_in_luma_samples
+  writer.writeUEV(PICTURE_SIZE); // pps_pic_height_in_luma_samples
+  writer.writeFlag(false);       // pps_conformance_window_flag
+  writer.writeFlag(false);       // pps_scaling_window_explicit_signalling_flag
+  writer.writeFlag(false);       // pps_output_flag_present_flag
+  writer.writeFlag(true);        // pps_no_pic_partition_flag
+  writer.writeFlag(false);       // pps_subpic_id_mapping_present_flag
+  writer.writeFlag(false);       // pps_cabac_init_present_flag
+  writer.writeUEV(0);            // pps_num_ref_idx_default_active_minus1[0]
+  writer.writeUEV(0);            // pps_num_ref_idx_default_active_minus1[1]
+  writer.writeFlag(false);       // pps_rpl1_idx_present_flag
+  writer.writeFlag(false);       // pps_weighted_pred_flag
+  writer.writeFlag(false);       // pps_weighted_bipred_flag
+  writer.writeFlag(false);       // pps_ref_wraparound_enabled_flag
+  writer.writeSEV(6);            // pps_init_qp_minus26
+  writer.writeFlag(false);       // pps_cu_qp_delta_enabled_flag
+  writer.writeFlag(false);       // pps_chroma_tool_offsets_present_flag
+  writer.writeFlag(false);       // pps_deblocking_filter_control_present_flag
+  writer.writeFlag(false);       // pps_picture_header_extension_present_flag
+  writer.writeFlag(false);       // pps_slice_header_extension_present_flag
+  writer.writeFlag(false);       // pps_extension_flag
+  writer.writeTrailingBits();
+  return writer.data;
+}
+
+QByteArray createAUD(const Picture &picture)
+{
+  BitWriter writer;
+  writer.writeFlag(isIRAP(picture.nalType)); // aud_irap_or_gdr_flag
+  writer.writeBits(unsigned(SliceType::I) - unsigned(picture.sliceType), 3); // aud_pic_type
+  writer.writeTrailingBits();
+  return writer.data;
+}
+
+void writePictureHeader(BitWriter &writer, const StreamSettings &settings, const Picture &picture)
+{
+  const auto isInter = picture.sliceType != SliceType::I;
+
+  writer.writeFlag(isIRAP(picture.nalType)); // ph_gdr_or_irap_pic_flag
+  writer.writeFlag(picture.nonReference);    // ph_non_ref_pic_flag
+  if (isIRAP(picture.nalType))
+    writer.writeFlag(false); // ph_gdr_pic_flag
+  writer.writeFlag(isInter); // ph_inter_slice_allowed_flag
+  if (isInter)
+    writer.writeFlag(true); // ph_intra_slice_allowed_flag
+  writer.writeUEV(0);       // ph_pic_parameter_set_id
+  writer.writeBits(picture.poc % (1u << settings.log2MaxPocLsb),
+                   settings.log2MaxPocLsb); // ph_pic_order_cnt_lsb
+  if (isInter)
+    writer.writeFlag(false); // ph_mvd_l1_zero_flag
+}
+
+void writeRefPicListStruct(BitWriter &writer, const std::vector<int> &references)
+{
+  writer.writeUEV(references.size()); // num_ref_entries
+  for (const auto deltaPoc : references)
+  {
+    writer.writeUEV(unsigned(std::abs(deltaPoc)) - 1); // abs_delta_poc_st
+    writer.writeFlag(deltaPoc < 0);                    // strp_entry_sign_flag
+  }
+}
+
+// Deterministic pseudo random bytes (a 64 bit LCG) for the slice data
+QByteArray createSliceData(int size, uint64_t &randomState)
+{
+  QByteArray data(size, char(0));
+  for (int i = 0; i < size; i++)
+  {
+    randomState = randomState * 6364136223846793005ull + 1442695040888963407ull;
+    data[i]     = char(randomState >> 56);
+  }
+  return data;
+}
+
+QByteArray
+createSlice(const StreamSettings &settings, const Picture &picture, uint64_t &randomState)
+{
+  const auto isInter = picture.sliceType != SliceType::I;
+  const auto isIDR =
+      picture.nalType == NalType::IDR_W_RADL || picture.nalType == NalType::IDR_N_LP;
+
+  BitWriter writer;
+  writer.writeFlag(true); // sh_picture_header_in_slice_header_flag
+  writePictureHeader(writer, settings, picture);
+  if (isInter)
+    writer.writeUEV(unsigned(picture.sliceType)); // sh_slice_type
+  if (isIRAP(picture.nalType))
+    writer.writeFlag(false); // sh_no_output_of_prior_pics_flag
+  if (!isIDR)
+  {
+    writeRefPicListStruct(writer, picture.referencesL0);
+    writeRefPicListStruct(writer, picture.referencesL1);
+  }
+  if ((isInter && picture.referencesL0.size() > 1) ||
+      (picture.sliceType == SliceType::B && picture.referencesL1.size() > 1))
+    writer.writeFlag(false);            // sh_num_ref_idx_active_override_flag
+  writer.writeSEV(picture.temporalId); // sh_qp_delta
+  writer.writeTrailingBits();          // byte_alignment
+
+  // The slice data ends with the rbsp_slice_trailing_bits
+  writer.writeBytes(createSliceData(picture.sliceDataSize, randomState));
+  writer.writeTrailingBits();
+  return writer.data;
+}
+
+// An IDR picture followed by intra coded trailing pictures
+std::vector<Picture> createIntraPictures(unsigned nrPictures)
+{
+  std::vector<Picture> pictures;
+  for (unsigned i = 0; i < nrPictures; i++)
+  {
+    Picture picture;
+    picture.nalType       = (i == 0) ? NalType::IDR_N_LP : NalType::TRAIL_NUT;
+    picture.poc           = i;
+    picture.sliceDataSize = 600 + int(i * 37 % 300);
+    pictures.push_back(picture);
+  }
+  return pictures;
+}
+
+// A random access hierarchy of the given number of GOPs with 8 pictures each. The temporal
+// layers 0 to 3 and the pictures of the highest layer are not used for reference.
+std::vector<Picture> createRandomAccessPictures(unsigned nrGOPs)
+{
+  struct GOPEntry
+  {
+    unsigned pocOffset;
+    unsigned temporalId;
+    int      deltaPoc;
+  };
+  const std::vector<GOPEntry> gop = {
+      {8, 0, 8}, {4, 1, 4}, {2, 2, 2}, {1, 3, 1}, {3, 3, 1}, {6, 2, 2}, {5, 3, 1}, {7, 3, 1}};
+  const std::vector<int> sliceDataSizes = {500, 300, 180, 90};
+
+  std::vector<Picture> pictures;
+
+  Picture idr;
+  idr.nalType       = NalType::IDR_W_RADL;
+  idr.sliceDataSize = 1200;
+  pictures.push_back(idr);
+
+  for (unsigned i = 0; i < nrGOPs; i++)
+  {
+    for (const auto &entry : gop)
+    {
+      Picture picture;
+      picture.poc           = i * 8 + entry.pocOffset;
+      picture.temporalId    = entry.temporalId;
+      picture.sliceType     = SliceType::B;
+      picture.nonReference  = entry.temporalId == 3;
+      picture.referencesL0  = {-entry.deltaPoc};
+      picture.referencesL1  = {entry.temporalId == 0 ? -entry.deltaPoc : entry.deltaPoc};
+      picture.sliceDataSize = sliceDataSizes[entry.temporalId] + int(picture.poc * 13 % 40);
+      pictures.push_back(picture);
+    }
+  }
+  return pictures;
+}
+
+// Low delay P coding with a CRA picture every craPeriod pictures. Every P picture references the
+// two previous pictures (one directly after the CRA picture).
+std::vector<Picture> createLowDelayPictures(unsigned nrPictures, unsigned craPeriod)
+{
+  std::vector<Picture> pictures;
+  for (unsigned i = 0; i < nrPictures; i++)
+  {
+    Picture picture;
+    picture.poc = i;
+    if (i % craPeriod == 0)
+    {
+      picture.nalType       = NalType::CRA_NUT;
+      picture.sliceDataSize = 900;
+    }
+    else
+    {
+      picture.sliceType     = SliceType::P;
+      picture.referencesL0  = (i % craPeriod == 1) ? std::vector<int>({-1})
+                                                   : std::vector<int>({-1, -2});
+      picture.sliceDataSize = 250 + int(i * 29 % 120);
+    }
+    pictures.push_back(picture);
+  }
+  return pictures;
+}
+
+} // namespace
+
+QByteArray createNalUnit(NalType nalType, unsigned temporalId, QByteArray rbspData)
+{
+  QByteArray nal;
+  nal.append(char(0));
+  nal.append(char(0));
+  nal.append(char(1));
+  nal.append(char(0)); // forbidden_zero_bit, nuh_reserved_zero_bit, nuh_layer_id
+  nal.append(char((unsigned(nalType) << 3) | (temporalId + 1)));
+
+  // Insert an emulation prevention byte wherever two zero bytes are followed by a byte <= 3
+  unsigned nrZeroBytes = 0;
+  for (const auto byte : rbspData)
+  {
+    if (nrZeroBytes >= 2 && uint8_t(byte) <= 3)
+    {
+      nal.append(char(3));
+      nrZeroBytes = 0;
+    }
+    nal.append(byte);
+    nrZeroBytes = (byte == 0) ? nrZeroBytes + 1 : 0;
+  }
+  return nal;
+}
+
+QByteArray createStream(const StreamSettings &settings, const std::vector<Picture> &pictures)
+{
+  uint64_t   randomState = 0x5eed;
+  QByteArray stream;
+  for (const auto &picture : pictures)
+  {
+    const auto isFirstPicture = stream.isEmpty();
+    if (settings.accessUnitDelimiter)
+      stream.append(createNalUnit(NalType::AUD_NUT, picture.temporalId, createAUD(picture)));
+    if (isFirstPicture || (settings.repeatParameterSets && isIRAP(picture.nalType)))
+    {
+      stream.append(createNalUnit(NalType::SPS_NUT, 0, createSPS(settings)));
+      stream.append(createNalUnit(NalType::PPS_NUT, 0, createPPS()));
+    }
+    auto slice = createSlice(settings, picture, randomState);
+    stream.append(createNalUnit(picture.nalType, picture.temporalId, slice));
+  }
+  return stream;
+}
+
+std::vector<AnnexBFile> createParserCorpus()
+{
+  std::vector<AnnexBFile> corpus;
+
+  StreamSettings intraSettings;
+  intraSettings.log2MaxPocLsb = 4;
+  corpus.push_back({"intra-poc-wrap.vvc", createStream(intraSettings, createIntraPictures(40))});
+
+  StreamSettings randomAccessSettings;
+  randomAccessSettings.maxSublayers        = 4;
+  randomAccessSettings.accessUnitDelimiter = true;
+  corpus.push_back({"random-access-gop8.vvc",
+                    createStream(randomAccessSettings, createRandomAccessPictures(4))});
+
+  StreamSettings lowDelaySettings;
+  lowDelaySettings.log2MaxPocLsb       = 4;
+  lowDelaySettings.repeatParameterSets = true;
+  corpus.push_back(
+      {"low-delay-p.vvc", createStream(lowDelaySettings, createLowDelayPictures(32, 16))});
+
+  return corpus;
+}
+
+int writeParserCorpus(const QString &directory)
+{
+  ConsoleLogger logger;
+
+  if (!QDir().mkpath(directory))
+  {
+    logger.addMessage(QString("Error creating directory %1").arg(directory),
+                      LoggingPriority::Error);
+    return 1;
+  }
+
+  for (const auto &file : createParserCorpus())
+  {
+    QFile outputFile(QDir(directory).filePath(file.name));
+    if (!outputFile.open(QIODevice::WriteOnly) || outputFile.write(file.data) != file.data.size())
+    {
+      logger.addMessage(QString("Error writing file %1").arg(outputFile.fileName()),
+                        LoggingPriority::Error);
+      return 1;
+    }
+    logger.addMessage(QString("Wrote %1 (%2 bytes)").arg(file.name).arg(file.data.size()),
+                      LoggingPriority::Info);
+  }
+  return 0;
+}
+
+} // namespace cli::synthetic
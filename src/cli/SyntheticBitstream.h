@@ -0,0 +1,93 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#pragma once
+
+#include <parser/VVC/nal_unit_header.h>
+
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+namespace cli::synthetic
+{
+
+/* Synthetic VVC annex B bitstreams for the checks and benchmarks of the parser.
+ *
+ * The parameter sets, picture headers and slice headers are complete and valid, so the parser
+ * handles them like the NAL units of a real encoder. The slice data is not: It is a deterministic
+ * pseudo random payload of the given size which the parser skips (it does not parse the
+ * arithmetically coded data). So these streams can not be decoded.
+ */
+
+enum class SliceType
+{
+  B,
+  P,
+  I
+};
+
+struct Picture
+{
+  parser::vvc::NalType nalType{parser::vvc::NalType::TRAIL_NUT};
+  unsigned             poc{};
+  unsigned             temporalId{};
+  SliceType            sliceType{SliceType::I};
+  bool                 nonReference{};
+  // The POC differences to the reference pictures in list 0 and 1
+  std::vector<int> referencesL0;
+  std::vector<int> referencesL1;
+  // The size of the (pseudo random) slice data following the slice header in bytes
+  int sliceDataSize{};
+};
+
+struct StreamSettings
+{
+  unsigned log2MaxPocLsb{8};
+  unsigned maxSublayers{1};
+  bool     accessUnitDelimiter{};
+  // Repeat the SPS and PPS in front of every IRAP picture
+  bool repeatParameterSets{};
+};
+
+QByteArray createStream(const StreamSettings &settings, const std::vector<Picture> &pictures);
+
+// A NAL unit (with start code) of the base layer. The RBSP must end with the trailing bits.
+// Emulation prevention bytes are inserted where needed.
+QByteArray createNalUnit(parser::vvc::NalType nalType, unsigned temporalId, QByteArray rbspData);
+
+struct AnnexBFile
+{
+  QString    name;
+  QByteArray data;
+};
+
+// The files of the corpus in benchmarks/parser-corpus. They cover intra only coding with POC
+// wrapping, a random access hierarchy with access unit delimiters and four temporal layers and low
+// delay P coding with CRA pictures.
+std::vector<AnnexBFile> createParserCorpus();
+
+// Write all files of the parser corpus to the directory. Returns the exit code for the
+// application.
+int writeParserCorpus(const QString &directory);
+
+} // namespace cli::synthetic
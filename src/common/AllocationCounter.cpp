@@ -0,0 +1,150 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(Q_OS_WIN)
+#include <malloc.h>
+#endif
+
+namespace
+{
+
+thread_local uint64_t nrAllocationsOfThread{};
+
+void *allocate(std::size_t size)
+{
+  nrAllocationsOfThread++;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+  nrAllocationsOfThread++;
+  if (size == 0)
+    size = 1;
+#if defined(Q_OS_WIN)
+  return _aligned_malloc(size, std::size_t(alignment));
+#else
+  void *p{};
+  if (posix_memalign(&p, std::max(std::size_t(alignment), sizeof(void *)), size) != 0)
+    return nullptr;
+  return p;
+#endif
+}
+
+void freeAligned(void *p)
+{
+#if defined(Q_OS_WIN)
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+} // namespace
+
+namespace allocation
+{
+
+bool     isCountingAllocations() { return true; }
+uint64_t getNumberAllocationsOfCurrentThread() { return nrAllocationsOfThread; }
+
+} // namespace allocation
+
+// Replace the global allocation functions including the aligned variants
+void *operator new(std::size_t size)
+{
+  if (auto p = allocate(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+  if (auto p = allocate(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (auto p = allocateAligned(size, alignment))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+  if (auto p = allocateAligned(size, alignment))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return allocateAligned(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return allocateAligned(size, alignment);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  freeAligned(p);
+}
+
+#else
+
+namespace allocation
+{
+
+bool     isCountingAllocations() { return false; }
+uint64_t getNumberAllocationsOfCurrentThread() { return 0; }
+
+} // namespace allocation
+
+#endif
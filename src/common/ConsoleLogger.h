@@ -0,0 +1,58 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include "ILogger.h"
+
+#include <iostream>
+#include <mutex>
+
+// A logger for command line modes without a GUI. All messages are written to stderr.
+class ConsoleLogger : public ILogger
+{
+public:
+  ConsoleLogger() = default;
+
+  void addMessage(QString message, LoggingPriority priority) override
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    switch (priority)
+    {
+    case LoggingPriority::Error:
+      std::cerr << "Error: ";
+      break;
+    case LoggingPriority::Warning:
+      std::cerr << "Warning: ";
+      break;
+    default:
+      break;
+    }
+    std::cerr << message.toStdString() << std::endl;
+  }
+
+  void clearMessages() override {}
+
+private:
+  std::mutex mutex;
+};
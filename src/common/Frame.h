@@ -26,11 +26,12 @@ SOFTWARE. */
 #include "Typedef.h"
 #include <QByteArray>
 #include <QImage>
+#include <chrono>
 #include <video/PixelFormatYUV.h>
 
 enum class FrameState
 {
-  ConvertedToRGB, // Ready for display (rgbImage filled)
+  ConvertedToRGB, // Ready for display (rgbImage filled unless the YUV data is rendered directly)
   Decoded,        // Frame is YUV, waiting for conversion to RGB (rawYUVData set)
   Empty
 };
@@ -42,21 +43,36 @@ public:
 
   void clear()
   {
-    this->frameState        = FrameState::Empty;
-    this->frameSize         = {};
-    this->pixelFormat       = {};
-    this->nrBytesCompressed = 0;
-    this->poc               = 0;
+    this->frameState           = FrameState::Empty;
+    this->frameSize            = {};
+    this->pixelFormat          = {};
+    this->nrBytesCompressed    = 0;
+    this->compressedDataOffset = 0;
+    this->poc                  = 0;
+    this->temporalId           = 0;
+    this->nonReference         = false;
+    this->dropped              = false;
   }
 
   FrameState frameState{FrameState::Empty};
+  // The frame was not decoded. It goes through the pipeline without an image and the
+  // previous image is shown again in its place.
+  bool dropped{false};
 
   QByteArray                    rawYUVData;
   Size                          frameSize{};
   video::yuv::PixelFormatYUV pixelFormat{};
 
+  // The position of the access unit in the compressed data of the segment
   size_t   nrBytesCompressed{0};
+  size_t   compressedDataOffset{0};
   unsigned poc{0};
+  unsigned temporalId{0};
+  // No other picture references this one so it can be dropped without affecting other pictures
+  bool nonReference{false};
+
+  // When the access unit was pushed to the decoder (for the decoder statistics)
+  std::chrono::steady_clock::time_point pushedToDecoderTime;
 
   QImage rgbImage;
 };
@@ -27,7 +27,12 @@ SOFTWARE. */
 
 #include <QByteArray>
 #include <QString>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <numeric>
+#include <vector>
 
 class Segment
 {
@@ -39,11 +44,35 @@ public:
   {
     this->segmentInfo         = {};
     this->compressedSizeBytes = 0;
+    this->isLocalFile         = false;
     this->downloadProgress    = 0.0;
     this->downloadFinished    = false;
     this->parsingFinished     = false;
+    this->claimedForDecoding  = false;
+    this->parsingFinishedTime = {};
+    this->decodingStartTime   = {};
+    this->decoderWaitUs       = 0;
+    this->decodingRecorded    = false;
     this->nrFrames            = 0;
     this->frames.clear();
+    this->displayIndexOfAccessUnit.clear();
+    this->generation++;
+  }
+
+  // Must be called once all frames of the segment were added by the parser
+  void updateDisplayIndices()
+  {
+    std::vector<unsigned> accessUnitsInDisplayOrder(this->frames.size());
+    std::iota(accessUnitsInDisplayOrder.begin(), accessUnitsInDisplayOrder.end(), 0u);
+    std::stable_sort(accessUnitsInDisplayOrder.begin(),
+                     accessUnitsInDisplayOrder.end(),
+                     [this](unsigned a, unsigned b) {
+                       return this->frames[a]->poc < this->frames[b]->poc;
+                     });
+
+    this->displayIndexOfAccessUnit.resize(this->frames.size());
+    for (unsigned displayIndex = 0; displayIndex < accessUnitsInDisplayOrder.size(); displayIndex++)
+      this->displayIndexOfAccessUnit[accessUnitsInDisplayOrder[displayIndex]] = displayIndex;
   }
 
   struct SegmentInfo
@@ -62,9 +91,32 @@ public:
   using Percent = double;
   Percent downloadProgress{0.0};
   bool    downloadFinished{false};
-  bool    parsingFinished{false};
+  // Once set, the frames of the segment are no longer changed by the parser and can be read by
+  // other threads (e.g. for the buffer status)
+  std::atomic<bool> parsingFinished{false};
+
+  // Set by the decoder that decodes this segment (if segments are decoded independently)
+  std::atomic<bool> claimedForDecoding{false};
+
+  // Incremented whenever the segment is cleared (while it is recycled). A thread that keeps a
+  // pointer to the segment can compare it to see if the segment was reused in the meantime.
+  std::atomic<uint64_t> generation{0};
+
+  // Timing of the decoding (for the decoder statistics)
+  std::chrono::steady_clock::time_point parsingFinishedTime;
+  std::chrono::steady_clock::time_point decodingStartTime;
+  int64_t                               decoderWaitUs{};
+  // Set by the one thread that adds the finished segment to the decoder statistics
+  std::atomic<bool> decodingRecorded{false};
 
   unsigned nrFrames{0};
 
+  /* There is one frame per access unit. The parser adds them in decoding order, so the access
+   * unit information of frame i (position and size of the data, POC, temporal ID, ...) belongs to
+   * access unit i in decoding order. The decoded picture of access unit i is stored in frame
+   * displayIndexOfAccessUnit[i] instead, so the pictures (frameState, rawYUVData, rgbImage) are in
+   * display order.
+   */
   std::vector<std::unique_ptr<Frame>> frames;
+  std::vector<unsigned>               displayIndexOfAccessUnit;
 };
@@ -23,6 +23,16 @@ SOFTWARE. */
 
 #include "functions.h"
 
+#include <QtGlobal>
+
+#if defined(Q_OS_WIN)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
 std::optional<std::size_t> findNextNalInData(const QByteArray &data, std::size_t start)
 {
   auto START_CODE = QByteArrayLiteral("\x00\x00\x01");
@@ -42,3 +52,54 @@ ByteVector convertToByteVector(QByteArray data)
   auto d = data.data();
   return ByteVector(d, d + data.size());
 }
+
+bool isURLLocalFile(const QString &url)
+{
+  return !url.startsWith("https://") && !url.startsWith("http://");
+}
+
+std::optional<std::size_t> getPeakResidentMemoryBytes()
+{
+#if defined(Q_OS_WIN)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return {};
+  return std::size_t(counters.PeakWorkingSetSize);
+#elif defined(Q_OS_UNIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return {};
+#if defined(Q_OS_MACOS)
+  // In bytes on macOS and in kilobytes everywhere else
+  return std::size_t(usage.ru_maxrss);
+#else
+  return std::size_t(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return {};
+#endif
+}
+
+std::optional<double> getProcessCPUTimeSeconds()
+{
+#if defined(Q_OS_WIN)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    return {};
+  auto toSeconds = [](const FILETIME &time) {
+    auto ticks = (uint64_t(time.dwHighDateTime) << 32) | uint64_t(time.dwLowDateTime);
+    return double(ticks) / 10000000.0;
+  };
+  return toSeconds(kernelTime) + toSeconds(userTime);
+#elif defined(Q_OS_UNIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return {};
+  auto toSeconds = [](const timeval &time) {
+    return double(time.tv_sec) + double(time.tv_usec) / 1000000.0;
+  };
+  return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+#else
+  return {};
+#endif
+}
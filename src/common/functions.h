@@ -27,6 +27,13 @@ SOFTWARE. */
 
 #include <optional>
 #include <QByteArray>
+#include <QString>
 
 std::optional<std::size_t> findNextNalInData(const QByteArray &data, std::size_t start);
 ByteVector convertToByteVector(QByteArray data);
+bool isURLLocalFile(const QString &url);
+
+// The peak resident memory of the process. Empty if the platform does not report it.
+std::optional<std::size_t> getPeakResidentMemoryBytes();
+// The CPU time (user and system) of all threads of the process so far in seconds
+std::optional<double> getProcessCPUTimeSeconds();
@@ -0,0 +1,126 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "DecoderSettings.h"
+
+#include <QSettings>
+
+namespace decoder
+{
+
+void SyntheticDecoderSettings::override(const SyntheticDecoderSettings &other)
+{
+  if (other.frameSize)
+    this->frameSize = other.frameSize;
+  if (other.subsampling)
+    this->subsampling = other.subsampling;
+  if (other.bitDepth)
+    this->bitDepth = other.bitDepth;
+  if (other.frameLatencyUs)
+    this->frameLatencyUs = other.frameLatencyUs;
+}
+
+void DecoderSettings::override(const DecoderSettings &other)
+{
+  if (other.engine)
+    this->engine = other.engine;
+  this->synthetic.override(other.synthetic);
+  if (other.threads)
+    this->threads = other.threads;
+  if (other.parseThreads)
+    this->parseThreads = other.parseThreads;
+  if (other.simd)
+    this->simd = other.simd;
+  if (other.upscaling)
+    this->upscaling = other.upscaling;
+  if (other.instances)
+    this->instances = other.instances;
+  if (other.skipNonReferenceThreshold)
+    this->skipNonReferenceThreshold = other.skipNonReferenceThreshold;
+}
+
+QString DecoderSettings::toString() const
+{
+  auto toText = [](std::optional<int> value) {
+    return value ? QString::number(*value) : QString("default");
+  };
+
+  QString text;
+  if (this->engine)
+    text += "Engine " + QString::fromStdString(DecoderEngineMapper.getName(*this->engine)) + " ";
+  text += "Threads " + toText(this->threads);
+  text += " ParseThreads " + toText(this->parseThreads);
+  text += " SIMD " + (this->simd ? QString::fromStdString(SIMDExtensionMapper.getName(*this->simd))
+                                 : QString("default"));
+  text += " Upscaling " +
+          (this->upscaling ? QString::fromStdString(UpscalingModeMapper.getName(*this->upscaling))
+                           : QString("default"));
+  text += " Instances " + toText(this->instances);
+  text += " SkipNonReferenceThreshold " + toText(this->skipNonReferenceThreshold);
+  if (this->engine == DecoderEngine::Synthetic)
+  {
+    using video::yuv::SubsamplingMapper;
+    const auto &synthetic = this->synthetic;
+    text += " Size " + (synthetic.frameSize ? QString("%1x%2")
+                                                   .arg(synthetic.frameSize->width)
+                                                   .arg(synthetic.frameSize->height)
+                                             : QString("default"));
+    text += " Subsampling " +
+            (synthetic.subsampling
+                 ? QString::fromStdString(SubsamplingMapper.getName(*synthetic.subsampling))
+                 : QString("default"));
+    text += " BitDepth " + toText(synthetic.bitDepth);
+    text += " FrameLatencyUs " + toText(synthetic.frameLatencyUs);
+  }
+  return text;
+}
+
+DecoderSettings DecoderSettings::fromApplicationSettings()
+{
+  DecoderSettings decoderSettings;
+
+  QSettings settings;
+  settings.beginGroup("Decoder");
+  if (settings.contains("Engine"))
+    decoderSettings.engine =
+        DecoderEngineMapper.getValue(settings.value("Engine").toString().toLower().toStdString());
+  if (settings.contains("Threads"))
+    decoderSettings.threads = settings.value("Threads").toInt();
+  if (settings.contains("ParseThreads"))
+    decoderSettings.parseThreads = settings.value("ParseThreads").toInt();
+  if (settings.contains("SIMD"))
+    decoderSettings.simd =
+        SIMDExtensionMapper.getValue(settings.value("SIMD").toString().toLower().toStdString());
+  if (settings.contains("Upscaling"))
+    decoderSettings.upscaling = UpscalingModeMapper.getValue(
+        settings.value("Upscaling").toString().toLower().toStdString());
+  if (settings.contains("Instances"))
+    decoderSettings.instances = settings.value("Instances").toInt();
+  if (settings.contains("SkipNonReferenceThreshold"))
+    decoderSettings.skipNonReferenceThreshold = settings.value("SkipNonReferenceThreshold").toInt();
+  settings.endGroup();
+
+  return decoderSettings;
+}
+
+} // namespace decoder
@@ -0,0 +1,124 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <common/EnumMapper.h>
+#include <common/Typedef.h>
+#include <video/PixelFormatYUV.h>
+
+#include <QString>
+#include <optional>
+
+namespace decoder
+{
+
+enum class DecoderEngine
+{
+  Invalid,
+  // Libde265, // The libde265 decoder
+  // HM,       // The HM reference software decoder
+  // VTM,      // The VTM reference software decoder
+  VVDec, // The VVDec VVC decoder
+  // Dav1d,    // The dav1d AV1 decoder
+  // FFMpeg    // The FFMpeg decoder
+  Synthetic // Outputs generated frames without decoding (see decoderSynthetic)
+};
+
+const auto DecoderEngineMapper = EnumMapper<DecoderEngine>(
+    {{DecoderEngine::VVDec, "vvdec"}, {DecoderEngine::Synthetic, "synthetic"}});
+
+enum class SIMDExtension
+{
+  Default,
+  Scalar,
+  SSE41,
+  SSE42,
+  AVX,
+  AVX2,
+  AVX512
+};
+
+const auto SIMDExtensionMapper = EnumMapper<SIMDExtension>({{SIMDExtension::Default, "default"},
+                                                            {SIMDExtension::Scalar, "scalar"},
+                                                            {SIMDExtension::SSE41, "sse41"},
+                                                            {SIMDExtension::SSE42, "sse42"},
+                                                            {SIMDExtension::AVX, "avx"},
+                                                            {SIMDExtension::AVX2, "avx2"},
+                                                            {SIMDExtension::AVX512, "avx512"}});
+
+enum class UpscalingMode
+{
+  Off,
+  CopyOnly,
+  Rescale
+};
+
+const auto UpscalingModeMapper = EnumMapper<UpscalingMode>({{UpscalingMode::Off, "off"},
+                                                            {UpscalingMode::CopyOnly, "copy"},
+                                                            {UpscalingMode::Rescale, "rescale"}});
+
+// The output of the synthetic decoder. Values that are not set keep the defaults of the decoder.
+struct SyntheticDecoderSettings
+{
+  std::optional<Size>                    frameSize;
+  std::optional<video::yuv::Subsampling> subsampling;
+  std::optional<int>                     bitDepth;
+  // The time that decoding of each access unit takes
+  std::optional<int> frameLatencyUs;
+
+  void override(const SyntheticDecoderSettings &other);
+};
+
+/* Configuration of the decoder. Values that are not set keep the default of the decoder library.
+ *
+ * The settings can come from the application settings, the manifest and the command line (in
+ * ascending priority). Use override to combine them.
+ */
+struct DecoderSettings
+{
+  // The default is VVDec
+  std::optional<DecoderEngine> engine;
+  SyntheticDecoderSettings     synthetic;
+
+  std::optional<int> threads;
+  // The number of parser threads. In vvdec this also sets how many frames are parsed ahead of the
+  // reconstruction (the parse delay).
+  std::optional<int>           parseThreads;
+  std::optional<SIMDExtension> simd;
+  std::optional<UpscalingMode> upscaling;
+  // The number of decoder instances that decode independent (closed GOP) segments in parallel
+  std::optional<int> instances;
+  // Non-reference pictures are not decoded while fewer than this many frames are decoded ahead
+  // of the displayed frame (0 never skips)
+  std::optional<int> skipNonReferenceThreshold;
+
+  // All values that are set in other replace the values in this
+  void override(const DecoderSettings &other);
+
+  QString toString() const;
+
+  static DecoderSettings fromApplicationSettings();
+};
+
+} // namespace decoder
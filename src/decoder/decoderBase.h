@@ -23,12 +23,15 @@ SOFTWARE. */
 
 #pragma once
 
+#include "DecoderSettings.h"
+
 #include <common/EnumMapper.h>
 #include <common/Typedef.h>
 #include <video/PixelFormatRGB.h>
 #include <video/PixelFormatYUV.h>
 
 #include <QLibrary>
+#include <optional>
 
 namespace decoder
 {
@@ -43,19 +46,6 @@ enum class DecoderState
   Error
 };
 
-enum class DecoderEngine
-{
-  Invalid,
-  // Libde265, // The libde265 decoder
-  // HM,       // The HM reference software decoder
-  // VTM,      // The VTM reference software decoder
-  VVDec, // The VVDec VVC decoder
-  // Dav1d,    // The dav1d AV1 decoder
-  // FFMpeg    // The FFMpeg decoder
-};
-
-const auto DecoderEngineMapper = EnumMapper<DecoderEngine>({{DecoderEngine::VVDec, "VVDec"}});
-
 /* This class is the abstract base class for all decoders. All decoders work like this:
  * 1. Create an instance and configure it (if required)
  * 2. Push data to the decoder until it returns that it can not take any more data.
@@ -84,10 +74,12 @@ public:
   video::yuv::PixelFormatYUV getPixelFormatYUV() const { return this->formatYUV; }
   video::rgb::PixelFormatRGB getRGBPixelFormat() const { return this->formatRGB; }
   Size                       getFrameSize() const { return this->frameSize; }
+  // The CTS of the current frame (if the access unit of the frame was pushed with a CTS)
+  std::optional<uint64_t> getFrameCTS() const { return this->frameCTS; }
   // Push data to the decoder (until no more data is needed)
   // In order to make the interface generic, the pushData function accepts data only without start
-  // codes
-  virtual bool pushData(QByteArray &data) = 0;
+  // codes. If a CTS is given, the frame decoded from the data will carry the same CTS.
+  virtual bool pushData(QByteArray &data, std::optional<uint64_t> cts = {}) = 0;
 
   DecoderState state() const { return this->decoderState; }
 
@@ -104,6 +96,11 @@ public:
   virtual QString getDecoderName() const = 0;
   virtual QString getCodecName() const   = 0;
 
+  // The settings that the decoder actually runs with (after applying the defaults of the library)
+  virtual QString getEffectiveSettings() const { return {}; }
+  // Information from the decoder library about itself (e.g. the version and SIMD extension)
+  virtual QString getDecoderInfo() const { return {}; }
+
 protected:
   DecoderState decoderState{DecoderState::NeedsMoreData};
 
@@ -113,6 +110,8 @@ protected:
   bool internalsSupported{false}; ///< Enable in the constructor if you support statistics
   Size frameSize;
 
+  std::optional<uint64_t> frameCTS;
+
   // Some decoders are able to handel both YUV and RGB output
   RawFormat                  rawFormat;
   video::yuv::PixelFormatYUV formatYUV;
@@ -0,0 +1,221 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "decoderSynthetic.h"
+
+#include <algorithm>
+#include <thread>
+
+#define DECODER_SYNTHETIC_DEBUG_OUTPUT 0
+#if DECODER_SYNTHETIC_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_SYNTHETIC(msg) qDebug() << msg
+#else
+#define DEBUG_SYNTHETIC(msg) ((void)0)
+#endif
+
+namespace decoder
+{
+
+namespace
+{
+
+constexpr auto NR_PATTERN_FRAMES      = 4u;
+constexpr auto PATTERN_STEP_PER_FRAME = 16u;
+constexpr auto DEFAULT_SUBSAMPLING    = video::yuv::Subsampling::YUV_420;
+constexpr auto DEFAULT_BIT_DEPTH      = 10;
+const auto     DEFAULT_FRAME_SIZE     = Size(1920u, 1080u);
+
+bool isSupportedSubsampling(video::yuv::Subsampling subsampling)
+{
+  using video::yuv::Subsampling;
+  return subsampling == Subsampling::YUV_420 || subsampling == Subsampling::YUV_422 ||
+         subsampling == Subsampling::YUV_444 || subsampling == Subsampling::YUV_400;
+}
+
+} // namespace
+
+decoderSynthetic::decoderSynthetic(const SyntheticDecoderSettings &settings) : decoderBase()
+{
+  this->resetDecoder();
+
+  auto latencyUs        = std::max(settings.frameLatencyUs.value_or(0), 0);
+  auto subsampling      = settings.subsampling.value_or(DEFAULT_SUBSAMPLING);
+  auto bitDepth         = settings.bitDepth.value_or(DEFAULT_BIT_DEPTH);
+  this->outputFrameSize = settings.frameSize.value_or(DEFAULT_FRAME_SIZE);
+  this->frameLatency    = std::chrono::microseconds(latencyUs);
+
+  if (!this->outputFrameSize.isValid())
+    this->setError("Invalid frame size for the synthetic decoder");
+  else if (bitDepth < 8 || bitDepth > 16)
+    this->setError("Invalid bit depth for the synthetic decoder");
+  else if (!isSupportedSubsampling(subsampling))
+    this->setError("Unsupported subsampling for the synthetic decoder");
+  else
+    this->outputFormat = video::yuv::PixelFormatYUV(subsampling, unsigned(bitDepth));
+}
+
+void decoderSynthetic::resetDecoder()
+{
+  decoderBase::resetDecoder();
+  this->rawFormat                     = RawFormat::YUV;
+  this->flushing                      = false;
+  this->currentFrameReadyForRetrieval = false;
+}
+
+void decoderSynthetic::createPatternFrames()
+{
+  const auto bitDepth       = this->outputFormat.getBitsPerSample();
+  const auto bytesPerSample = bitDepth > 8 ? 2u : 1u;
+  const auto shift          = unsigned(bitDepth - 8);
+  const auto lumaSize       = this->outputFrameSize;
+  const auto subsampling    = this->outputFormat.getSubsampling();
+  const auto subsamplingHor = unsigned(this->outputFormat.getSubsamplingHor());
+  const auto subsamplingVer = unsigned(this->outputFormat.getSubsamplingVer());
+  const auto nrChromaPlanes = (subsampling == video::yuv::Subsampling::YUV_400) ? 0u : 2u;
+  const auto chromaSize = Size(lumaSize.width / subsamplingHor, lumaSize.height / subsamplingVer);
+
+  auto writeSample = [bytesPerSample](unsigned char *&dst, unsigned value) {
+    // Samples with more than 8 bit are 16 bit little endian as output by vvdec
+    *dst++ = uint8_t(value & 0xff);
+    if (bytesPerSample == 2)
+      *dst++ = uint8_t(value >> 8);
+  };
+
+  for (unsigned i = 0; i < NR_PATTERN_FRAMES; i++)
+  {
+    QByteArray frame(int(this->outputFormat.bytesPerFrame(lumaSize)), 0);
+    auto       dst = reinterpret_cast<unsigned char *>(frame.data());
+
+    // A diagonal luma ramp in the limited range (16 to 235) that moves with every frame
+    for (unsigned y = 0; y < lumaSize.height; y++)
+      for (unsigned x = 0; x < lumaSize.width; x++)
+      {
+        auto value = 16u + ((x + y) / 4 + i * PATTERN_STEP_PER_FRAME) % 220u;
+        writeSample(dst, value << shift);
+      }
+
+    // Horizontal (U) and vertical (V) chroma ramps around the neutral value
+    for (unsigned c = 0; c < nrChromaPlanes; c++)
+      for (unsigned y = 0; y < chromaSize.height; y++)
+        for (unsigned x = 0; x < chromaSize.width; x++)
+        {
+          auto position = (c == 0) ? x * 64u / chromaSize.width : y * 64u / chromaSize.height;
+          writeSample(dst, (96u + position) << shift);
+        }
+
+    this->patternFrames.push_back(frame);
+  }
+}
+
+bool decoderSynthetic::decodeNextFrame()
+{
+  if (this->decoderState != DecoderState::RetrieveFrames)
+  {
+    DEBUG_SYNTHETIC("decoderSynthetic::decodeNextFrame: Wrong decoder state.");
+    return false;
+  }
+
+  // Every frame is output as soon as its access unit was pushed. So there is nothing left when
+  // flushing.
+  if (this->flushing)
+  {
+    DEBUG_SYNTHETIC("decoderSynthetic::decodeNextFrame: Flushing done. EOF.");
+    this->decoderState = DecoderState::EndOfBitstream;
+    return false;
+  }
+
+  if (this->currentFrameReadyForRetrieval)
+  {
+    this->decoderState                  = DecoderState::NeedsMoreData;
+    this->currentFrameReadyForRetrieval = false;
+    return false;
+  }
+
+  this->currentFrameReadyForRetrieval = true;
+  return true;
+}
+
+QByteArray decoderSynthetic::getRawFrameData()
+{
+  if (this->decoderState != DecoderState::RetrieveFrames || this->patternFrames.empty() ||
+      this->nrFramesOutput == 0)
+  {
+    DEBUG_SYNTHETIC("decoderSynthetic::getRawFrameData: No frame available.");
+    return {};
+  }
+
+  return this->patternFrames.at((this->nrFramesOutput - 1) % this->patternFrames.size());
+}
+
+bool decoderSynthetic::pushData(QByteArray &data, std::optional<uint64_t> cts)
+{
+  if (this->decoderState != DecoderState::NeedsMoreData)
+  {
+    DEBUG_SYNTHETIC("decoderSynthetic::pushData: Wrong decoder state.");
+    return false;
+  }
+  if (this->flushing)
+  {
+    DEBUG_SYNTHETIC("decoderSynthetic::pushData: Don't push more data when flushing.");
+    return false;
+  }
+
+  if (data.isEmpty())
+  {
+    DEBUG_SYNTHETIC("decoderSynthetic::pushData: Setting flushing mode");
+    this->flushing     = true;
+    this->decoderState = DecoderState::RetrieveFrames;
+    return true;
+  }
+
+  if (this->patternFrames.empty())
+    this->createPatternFrames();
+
+  if (this->frameLatency.count() > 0)
+    std::this_thread::sleep_for(this->frameLatency);
+
+  this->nrFramesOutput++;
+  this->frameSize    = this->outputFrameSize;
+  this->formatYUV    = this->outputFormat;
+  this->frameCTS     = cts;
+  this->decoderState = DecoderState::RetrieveFrames;
+  DEBUG_SYNTHETIC("decoderSynthetic::pushData pushed AU length " << data.length());
+  return true;
+}
+
+QString decoderSynthetic::getEffectiveSettings() const
+{
+  return QString("Size %1x%2 Format %3 FrameLatencyUs %4")
+      .arg(this->outputFrameSize.width)
+      .arg(this->outputFrameSize.height)
+      .arg(QString::fromStdString(this->outputFormat.getName()))
+      .arg(this->frameLatency.count());
+}
+
+QString decoderSynthetic::getDecoderInfo() const
+{
+  return "Synthetic decoder. Outputs generated frames without decoding.";
+}
+
+} // namespace decoder
@@ -0,0 +1,73 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include "DecoderSettings.h"
+#include "decoderBase.h"
+
+#include <chrono>
+#include <vector>
+
+namespace decoder
+{
+
+/* A decoder that does not decode. For every pushed access unit it outputs one generated frame
+ * with the configured size and format after the configured latency. This way the rest of the
+ * pipeline (parsing, buffering, conversion and display) can be tested and measured without the
+ * decoder library and with a known, constant decoding time.
+ */
+class decoderSynthetic : public decoderBase
+{
+public:
+  decoderSynthetic(const SyntheticDecoderSettings &settings = {});
+
+  void resetDecoder() override;
+
+  // Decoding / pushing data
+  bool       decodeNextFrame() override;
+  QByteArray getRawFrameData() override;
+  bool       pushData(QByteArray &data, std::optional<uint64_t> cts = {}) override;
+
+  QStringList getLibraryPaths() const override { return {}; }
+  QString     getDecoderName() const override { return "Synthetic"; }
+  QString     getCodecName() const override { return "vvc"; }
+  QString     getEffectiveSettings() const override;
+  QString     getDecoderInfo() const override;
+
+private:
+  Size                       outputFrameSize;
+  video::yuv::PixelFormatYUV outputFormat;
+  std::chrono::microseconds  frameLatency{};
+
+  // A few frames with a moving pattern are generated once (on the first pushed access unit) and
+  // are then output in turn. The frames share the data so that no copy is made per frame.
+  std::vector<QByteArray> patternFrames;
+  void                    createPatternFrames();
+  size_t                  nrFramesOutput{};
+
+  bool flushing{false};
+  bool currentFrameReadyForRetrieval{};
+};
+
+} // namespace decoder
@@ -26,7 +26,9 @@ SOFTWARE. */
 #include <QCoreApplication>
 #include <QDir>
 #include <QSettings>
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 #include "common/Typedef.h"
 
@@ -62,8 +64,6 @@ namespace decoder
 namespace
 {
 
-const auto MAX_CODED_PICTURE_SIZE = 800000;
-
 void loggingCallback(void *ptr, int level, const char *msg, va_list list)
 {
   (void)ptr;
@@ -105,9 +105,82 @@ Size calculateChromaSize(Size lumaSize, vvdecColorFormat fmt)
   return {};
 }
 
+vvdecSIMD_Extension convertToInternalSIMDExtension(SIMDExtension simd)
+{
+  switch (simd)
+  {
+  case SIMDExtension::Scalar:
+    return VVDEC_SIMD_SCALAR;
+  case SIMDExtension::SSE41:
+    return VVDEC_SIMD_SSE41;
+  case SIMDExtension::SSE42:
+    return VVDEC_SIMD_SSE42;
+  case SIMDExtension::AVX:
+    return VVDEC_SIMD_AVX;
+  case SIMDExtension::AVX2:
+    return VVDEC_SIMD_AVX2;
+  case SIMDExtension::AVX512:
+    return VVDEC_SIMD_AVX512;
+  default:
+    return VVDEC_SIMD_DEFAULT;
+  }
+}
+
+vvdecRPRUpscaling convertToInternalUpscaling(UpscalingMode upscaling)
+{
+  if (upscaling == UpscalingMode::CopyOnly)
+    return VVDEC_UPSCALING_COPY_ONLY;
+  if (upscaling == UpscalingMode::Rescale)
+    return VVDEC_UPSCALING_RESCALE;
+  return VVDEC_UPSCALING_OFF;
+}
+
+// The entries of the SIMDExtensionMapper are in the same order as the values of vvdecSIMD_Extension
+QString convertFromInternalSIMDExtension(vvdecSIMD_Extension simd)
+{
+  if (simd == VVDEC_SIMD_DEFAULT)
+    return "default";
+  auto value = SIMDExtensionMapper.at(size_t(simd));
+  if (!value)
+    return "unknown";
+  return QString::fromStdString(SIMDExtensionMapper.getName(*value));
+}
+
 } // namespace
 
-decoderVVDec::decoderVVDec() : decoderBaseSingleLib()
+bool reserveAccessUnitPayload(const LibraryFunctionsVVDec &lib,
+                              vvdecAccessUnit &            accessUnit,
+                              int                          size)
+{
+  if (accessUnit.payload != nullptr && accessUnit.payloadSize >= size)
+    return true;
+
+  auto newSize = std::max(accessUnit.payloadSize, INITIAL_VVDEC_PAYLOAD_SIZE);
+  while (newSize < size)
+    newSize = (newSize > std::numeric_limits<int>::max() / 2) ? size : newSize * 2;
+
+  DEBUG_vvdec("reserveAccessUnitPayload growing payload from " << accessUnit.payloadSize
+                                                               << " to " << newSize << " bytes");
+
+  lib.vvdec_accessUnit_free_payload(&accessUnit);
+  lib.vvdec_accessUnit_alloc_payload(&accessUnit, newSize);
+  return accessUnit.payload != nullptr;
+}
+
+bool copyToAccessUnitPayload(const LibraryFunctionsVVDec &lib,
+                             vvdecAccessUnit &            accessUnit,
+                             const QByteArray &           data)
+{
+  if (!reserveAccessUnitPayload(lib, accessUnit, data.size()))
+    return false;
+
+  std::memcpy(accessUnit.payload, data.constData(), data.size());
+  accessUnit.payloadUsedSize = data.size();
+  return true;
+}
+
+decoderVVDec::decoderVVDec(const DecoderSettings &settings)
+    : decoderBaseSingleLib(), settings(settings)
 {
   this->rawFormat = RawFormat::YUV;
   this->loadLibrary();
@@ -146,6 +219,29 @@ decoderVVDec::~decoderVVDec()
   }
 }
 
+QString decoderVVDec::getEffectiveSettings() const
+{
+  auto threadsText = [](int threads) {
+    return threads < 0 ? QString("auto") : QString::number(threads);
+  };
+  auto upscalingIndex = size_t(this->effectiveParams.upscaleOutput);
+  auto upscaling      = UpscalingModeMapper.at(upscalingIndex).value_or(UpscalingMode::Off);
+  auto upscalingText = UpscalingModeMapper.getName(upscaling);
+
+  return QString("Threads %1 ParseThreads %2 SIMD %3 Upscaling %4")
+      .arg(threadsText(this->effectiveParams.threads))
+      .arg(threadsText(this->effectiveParams.parseThreads))
+      .arg(convertFromInternalSIMDExtension(this->effectiveParams.simd))
+      .arg(QString::fromStdString(upscalingText));
+}
+
+QString decoderVVDec::getDecoderInfo() const
+{
+  if (this->decoder == nullptr)
+    return {};
+  return QString(this->lib.vvdec_get_dec_information(this->decoder)).trimmed();
+}
+
 QStringList decoderVVDec::getLibraryNames() const
 {
   // If the file name is not set explicitly, QLibrary will try to open the .so file first.
@@ -173,6 +269,8 @@ void decoderVVDec::resolveLibraryFunctionPointers()
     return;
   if (!resolve(this->lib.vvdec_accessUnit_alloc_payload, "vvdec_accessUnit_alloc_payload"))
     return;
+  if (!resolve(this->lib.vvdec_accessUnit_free_payload, "vvdec_accessUnit_free_payload"))
+    return;
   if (!resolve(this->lib.vvdec_accessUnit_default, "vvdec_accessUnit_default"))
     return;
 
@@ -242,6 +340,15 @@ void decoderVVDec::allocateNewDecoder()
   this->lib.vvdec_params_default(&params);
 
   params.logLevel = VVDEC_INFO;
+  if (this->settings.threads)
+    params.threads = *this->settings.threads;
+  if (this->settings.parseThreads)
+    params.parseThreads = *this->settings.parseThreads;
+  if (this->settings.simd)
+    params.simd = convertToInternalSIMDExtension(*this->settings.simd);
+  if (this->settings.upscaling)
+    params.upscaleOutput = convertToInternalUpscaling(*this->settings.upscaling);
+  this->effectiveParams = params;
 
   this->decoder = this->lib.vvdec_decoder_open(&params);
   if (this->decoder == nullptr)
@@ -268,12 +375,27 @@ void decoderVVDec::allocateNewDecoder()
       this->setError("Error allocating access unit");
       return;
     }
-    this->lib.vvdec_accessUnit_alloc_payload(this->accessUnit, MAX_CODED_PICTURE_SIZE);
-    if (this->accessUnit->payload == nullptr)
+    if (!reserveAccessUnitPayload(this->lib, *this->accessUnit, INITIAL_VVDEC_PAYLOAD_SIZE))
       this->setError("Error allocating AU payload buffer");
   }
 }
 
+int decoderVVDec::decodeAccessUnit(const QByteArray &data, std::optional<uint64_t> cts)
+{
+  this->accessUnit->cts      = cts.value_or(0);
+  this->accessUnit->ctsValid = cts.has_value();
+
+  // The data is copied into the payload buffer which is owned by the access unit. The data
+  // usually references the segment buffer, which vvdec must not alias.
+  if (!copyToAccessUnitPayload(this->lib, *this->accessUnit, data))
+  {
+    this->setError("Error allocating AU payload buffer");
+    return VVDEC_ERR_ALLOCATE;
+  }
+
+  return this->lib.vvdec_decode(this->decoder, this->accessUnit, &this->currentFrame);
+}
+
 bool decoderVVDec::decodeNextFrame()
 {
   if (this->decoderState != DecoderState::RetrieveFrames)
@@ -364,6 +486,9 @@ bool decoderVVDec::getNextFrameFromDecoder()
   }
 
   this->frameSize = lumaSize;
+  this->frameCTS  = {};
+  if (this->currentFrame->ctsValid)
+    this->frameCTS = this->currentFrame->cts;
   if (!this->formatYUV.isValid())
     this->formatYUV = video::yuv::PixelFormatYUV(subsampling, bitDepth);
   else
@@ -379,7 +504,7 @@ bool decoderVVDec::getNextFrameFromDecoder()
   return true;
 }
 
-bool decoderVVDec::pushData(QByteArray &data)
+bool decoderVVDec::pushData(QByteArray &data, std::optional<uint64_t> cts)
 {
   if (decoderState != DecoderState::NeedsMoreData)
   {
@@ -403,13 +528,9 @@ bool decoderVVDec::pushData(QByteArray &data)
   }
   else
   {
-    if (data.size() > this->accessUnit->payloadSize)
-      return setErrorB("Access unit too big to push");
-
-    std::memcpy(this->accessUnit->payload, data.constData(), data.size());
-    this->accessUnit->payloadUsedSize = data.size();
-
-    auto ret = this->lib.vvdec_decode(this->decoder, this->accessUnit, &this->currentFrame);
+    auto ret = this->decodeAccessUnit(data, cts);
+    if (this->decoderState == DecoderState::Error)
+      return false;
     if (ret == VVDEC_EOF)
       endOfFile = true;
     else if (ret != VVDEC_TRY_AGAIN && ret != VVDEC_OK)
@@ -422,7 +543,7 @@ bool decoderVVDec::pushData(QByteArray &data)
                            .arg(cErrAdd));
     }
 
-    DEBUG_vvdec("decoderVVDec::pushData pushed NAL length "
+    DEBUG_vvdec("decoderVVDec::pushData pushed AU length "
                 << data.length() << (this->currentFrame != nullptr ? " frameAvailable" : ""));
   }
 
@@ -25,6 +25,7 @@ SOFTWARE. */
 
 #include <QLibrary>
 
+#include "DecoderSettings.h"
 #include "decoderBase.h"
 #include "vvdec/vvdec.h"
 
@@ -39,6 +40,7 @@ struct LibraryFunctionsVVDec
   vvdecAccessUnit *(*vvdec_accessUnit_alloc)(){};
   void (*vvdec_accessUnit_free)(vvdecAccessUnit *accessUnit){};
   void (*vvdec_accessUnit_alloc_payload)(vvdecAccessUnit *accessUnit, int payload_size){};
+  void (*vvdec_accessUnit_free_payload)(vvdecAccessUnit *accessUnit){};
   void (*vvdec_accessUnit_default)(vvdecAccessUnit *accessUnit){};
 
   void (*vvdec_params_default)(vvdecParams *param){};
@@ -58,11 +60,28 @@ struct LibraryFunctionsVVDec
   const char *(*vvdec_get_error_msg)(int nRet){};
 };
 
+// The initial size of the AU payload buffer. It grows if a bigger access unit is pushed.
+constexpr int INITIAL_VVDEC_PAYLOAD_SIZE = 800000;
+
+// Make sure that the AU payload buffer can hold at least the given number of bytes. The buffer
+// grows geometrically so that a few large pictures don't cause a reallocation each time. The
+// buffer is (re)allocated with the payload functions of the library. Returns false if the
+// allocation failed.
+bool reserveAccessUnitPayload(const LibraryFunctionsVVDec &lib,
+                              vvdecAccessUnit &            accessUnit,
+                              int                          size);
+
+// Copy the data into the payload buffer of the access unit (which grows if needed) and set the
+// used size. Returns false if the buffer could not be allocated.
+bool copyToAccessUnitPayload(const LibraryFunctionsVVDec &lib,
+                             vvdecAccessUnit &            accessUnit,
+                             const QByteArray &           data);
+
 // This class wraps the decoder library in a demand-load fashion.
 class decoderVVDec : public decoderBaseSingleLib
 {
 public:
-  decoderVVDec();
+  decoderVVDec(const DecoderSettings &settings = {});
   decoderVVDec(bool loadLibrary);
   ~decoderVVDec();
 
@@ -71,13 +90,15 @@ public:
   // Decoding / pushing data
   bool       decodeNextFrame() override;
   QByteArray getRawFrameData() override;
-  bool       pushData(QByteArray &data) override;
+  bool       pushData(QByteArray &data, std::optional<uint64_t> cts = {}) override;
 
   // Check if the given library file is an existing libde265 decoder that we can use.
   static bool checkLibraryFile(QString libFilePath, QString &error);
 
   QString getDecoderName() const override;
   QString getCodecName() const override { return "hevc"; }
+  QString getEffectiveSettings() const override;
+  QString getDecoderInfo() const override;
 
 private:
   void loadLibrary();
@@ -95,6 +116,11 @@ private:
 
   void allocateNewDecoder();
 
+  int decodeAccessUnit(const QByteArray &data, std::optional<uint64_t> cts);
+
+  DecoderSettings settings;
+  vvdecParams     effectiveParams{};
+
   vvdecDecoder *   decoder{nullptr};
   vvdecAccessUnit *accessUnit{nullptr};
   vvdecFrame *     currentFrame{nullptr};
@@ -42,6 +42,10 @@ struct BitrateEntry
   size_t  bitrate{0};
   bool    keyframe{false};
   QString frameType{};
+
+  unsigned temporalId{0};
+  // The picture is not used for reference by any other picture (ph_non_ref_pic_flag in VVC)
+  bool nonReference{false};
 };
 
 using FrameIndexDisplayOrder = unsigned;
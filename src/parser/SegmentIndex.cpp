@@ -0,0 +1,272 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "SegmentIndex.h"
+
+#include <common/functions.h>
+#include <parser/VVC/AnnexBVVC.h>
+#include <parser/VVC/nal_unit_header.h>
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#define SEGMENT_INDEX_DEBUG_OUTPUT 0
+#if SEGMENT_INDEX_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_INDEX(msg) qDebug() << msg
+#else
+#define DEBUG_INDEX(msg) ((void)0)
+#endif
+
+namespace parser
+{
+
+namespace
+{
+
+// "VVCI" in little endian
+constexpr quint32 INDEX_FILE_MAGIC   = 0x49435656;
+constexpr quint32 INDEX_FILE_VERSION = 3;
+
+constexpr quint8 AU_FLAG_KEYFRAME      = 0x01;
+constexpr quint8 AU_FLAG_NON_REFERENCE = 0x02;
+
+void setupStream(QDataStream &stream)
+{
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+bool isWithinSegment(uint64_t offset, uint64_t sizeBytes, uint64_t segmentSizeBytes)
+{
+  return offset <= segmentSizeBytes && sizeBytes <= segmentSizeBytes - offset;
+}
+
+} // namespace
+
+SegmentIndex buildSegmentIndex(const QByteArray &                      segmentData,
+                               std::vector<int> *                      nalsWithErrors,
+                               const bool *                            abort,
+                               std::shared_ptr<vvc::ParameterSetCache> parameterSetCache)
+{
+  SegmentIndex index;
+  index.segmentSizeBytes = uint64_t(segmentData.size());
+  index.segmentHash      = calculateSegmentHash(segmentData);
+
+  auto firstPos = findNextNalInData(segmentData, 0);
+  if (!firstPos)
+    return index;
+
+  AnnexBVVC parser(parameterSetCache);
+
+  size_t currentDataOffset = *firstPos;
+  size_t currentAUStart    = *firstPos;
+  int    nalID             = 0;
+  while (abort == nullptr || !*abort)
+  {
+    const auto nalStart = currentDataOffset;
+
+    QByteArray nalData;
+    if (auto nextNalStart = findNextNalInData(segmentData, currentDataOffset + 3))
+    {
+      auto length       = *nextNalStart - currentDataOffset;
+      nalData           = segmentData.mid(currentDataOffset, length);
+      currentDataOffset = *nextNalStart;
+    }
+    else if (currentDataOffset < size_t(segmentData.size()))
+    {
+      nalData           = segmentData.mid(currentDataOffset);
+      currentDataOffset = segmentData.size();
+    }
+
+    // After the last NAL, the parser is called one more time with empty data to finish the last AU
+    const auto isEndOfData = nalData.isEmpty();
+    if (isEndOfData)
+      nalID = -1;
+    else if (auto nalType = vvc::getNalTypeFromRawData(nalData.constData(), nalData.size()))
+    {
+      if (vvc::isParameterSet(*nalType))
+        index.parameterSetOffsets.push_back(nalStart);
+    }
+
+    DEBUG_INDEX("Parsing NAL of " << nalData.size() << " bytes");
+    auto parseResult = parser.parseAndAddNALUnit(nalID, convertToByteVector(nalData), {});
+    if (!parseResult.success && nalsWithErrors != nullptr)
+      nalsWithErrors->push_back(nalID);
+
+    // The parser also reports the start of a new AU if the NAL that started it could not be parsed
+    // completely. Always close the previous AU so that the following AUs keep correct offsets.
+    if (parseResult.bitrateEntry)
+    {
+      // The previous AU ends right before the NAL that started the new one
+      SegmentIndex::AccessUnit accessUnit;
+      accessUnit.offset       = currentAUStart;
+      accessUnit.sizeBytes    = nalStart - currentAUStart;
+      accessUnit.poc          = parseResult.bitrateEntry->pts;
+      accessUnit.keyframe     = parseResult.bitrateEntry->keyframe;
+      accessUnit.temporalId   = parseResult.bitrateEntry->temporalId;
+      accessUnit.nonReference = parseResult.bitrateEntry->nonReference;
+      index.accessUnits.push_back(accessUnit);
+      currentAUStart = nalStart;
+
+      DEBUG_INDEX("AU POC " << accessUnit.poc << " offset " << accessUnit.offset << " size "
+                            << accessUnit.sizeBytes);
+    }
+
+    if (isEndOfData)
+      break;
+    nalID++;
+  }
+
+  return index;
+}
+
+QString getSegmentIndexFileName(const QString &segmentFileName) { return segmentFileName + ".idx"; }
+
+// FNV-1a over the segment data
+uint64_t calculateSegmentHash(const QByteArray &segmentData)
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  for (const auto c : segmentData)
+  {
+    hash ^= uint64_t(uint8_t(c));
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+bool isSegmentIndexValidForSegment(const SegmentIndex &index, const QByteArray &segmentData)
+{
+  return index.segmentSizeBytes == uint64_t(segmentData.size()) &&
+         index.segmentHash == calculateSegmentHash(segmentData);
+}
+
+bool writeSegmentIndexFile(const QString &fileName, const SegmentIndex &index)
+{
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+
+  QDataStream stream(&file);
+  setupStream(stream);
+
+  stream << INDEX_FILE_MAGIC << INDEX_FILE_VERSION;
+  stream << quint64(index.segmentSizeBytes) << quint64(index.segmentHash);
+
+  stream << quint32(index.accessUnits.size());
+  for (const auto &accessUnit : index.accessUnits)
+  {
+    quint8 flags = accessUnit.keyframe ? AU_FLAG_KEYFRAME : 0;
+    if (accessUnit.nonReference)
+      flags |= AU_FLAG_NON_REFERENCE;
+    stream << quint64(accessUnit.offset) << quint64(accessUnit.sizeBytes) << qint32(accessUnit.poc)
+           << flags << quint8(accessUnit.temporalId);
+  }
+
+  stream << quint32(index.parameterSetOffsets.size());
+  for (const auto offset : index.parameterSetOffsets)
+    stream << quint64(offset);
+
+  if (stream.status() != QDataStream::Ok)
+    return false;
+  return file.commit();
+}
+
+std::optional<SegmentIndex> readSegmentIndexFile(const QString &fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+
+  QDataStream stream(&file);
+  setupStream(stream);
+
+  quint32 magic{};
+  quint32 version{};
+  stream >> magic >> version;
+  if (magic != INDEX_FILE_MAGIC || version != INDEX_FILE_VERSION)
+  {
+    DEBUG_INDEX("Index file " << fileName << " has wrong magic or version");
+    return {};
+  }
+
+  SegmentIndex index;
+
+  quint64 segmentSizeBytes{};
+  quint64 segmentHash{};
+  stream >> segmentSizeBytes >> segmentHash;
+  index.segmentSizeBytes = segmentSizeBytes;
+  index.segmentHash      = segmentHash;
+
+  quint32 nrAccessUnits{};
+  stream >> nrAccessUnits;
+  for (quint32 i = 0; i < nrAccessUnits && stream.status() == QDataStream::Ok; i++)
+  {
+    quint64 offset{};
+    quint64 sizeBytes{};
+    qint32  poc{};
+    quint8  flags{};
+    quint8  temporalId{};
+    stream >> offset >> sizeBytes >> poc >> flags >> temporalId;
+    if (!isWithinSegment(offset, sizeBytes, segmentSizeBytes))
+    {
+      DEBUG_INDEX("AU " << i << " in index file " << fileName << " is outside of the segment");
+      return {};
+    }
+
+    SegmentIndex::AccessUnit accessUnit;
+    accessUnit.offset       = offset;
+    accessUnit.sizeBytes    = sizeBytes;
+    accessUnit.poc          = poc;
+    accessUnit.keyframe     = (flags & AU_FLAG_KEYFRAME) != 0;
+    accessUnit.nonReference = (flags & AU_FLAG_NON_REFERENCE) != 0;
+    accessUnit.temporalId   = temporalId;
+    index.accessUnits.push_back(accessUnit);
+  }
+
+  quint32 nrParameterSets{};
+  stream >> nrParameterSets;
+  for (quint32 i = 0; i < nrParameterSets && stream.status() == QDataStream::Ok; i++)
+  {
+    quint64 offset{};
+    stream >> offset;
+    if (offset >= segmentSizeBytes)
+    {
+      DEBUG_INDEX("Parameter set " << i << " in index file " << fileName
+                                   << " is outside of the segment");
+      return {};
+    }
+    index.parameterSetOffsets.push_back(offset);
+  }
+
+  if (stream.status() != QDataStream::Ok)
+  {
+    DEBUG_INDEX("Error reading index file " << fileName);
+    return {};
+  }
+
+  return index;
+}
+
+} // namespace parser
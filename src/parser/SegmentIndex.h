@@ -0,0 +1,86 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <parser/VVC/ParameterSetCache.h>
+
+#include <QByteArray>
+#include <QString>
+#include <optional>
+#include <vector>
+
+namespace parser
+{
+
+/* A compact index of one segment (one VVC annex B file).
+ *
+ * This holds everything the player needs to know about a segment without parsing it again: The
+ * position and size of every access unit together with its POC, temporal ID and whether it is a
+ * keyframe or a non-reference picture, as well as the positions of all parameter sets. The index
+ * can be written to a sidecar file next to the segment so that local libraries only have to be
+ * parsed once.
+ */
+struct SegmentIndex
+{
+  struct AccessUnit
+  {
+    uint64_t offset{};    // Position of the first byte (start code) of the AU in the segment
+    uint64_t sizeBytes{}; // Size of all NAL units of the AU including start codes
+    int      poc{};
+    bool     keyframe{};
+    unsigned temporalId{};
+    bool     nonReference{};
+  };
+  std::vector<AccessUnit> accessUnits;
+  std::vector<uint64_t>   parameterSetOffsets;
+
+  // The size and a hash of the data of the segment that was indexed. Used to detect outdated index
+  // files.
+  uint64_t segmentSizeBytes{};
+  uint64_t segmentHash{};
+};
+
+// Parse the given segment and build the index for it. The IDs of all NAL units that could not be
+// parsed are added to nalsWithErrors (if given). Parsing stops early if abort is set. If a
+// parameter set cache is given, parameter sets that were already parsed are taken from there.
+SegmentIndex buildSegmentIndex(const QByteArray &                      segmentData,
+                               std::vector<int> *                      nalsWithErrors    = nullptr,
+                               const bool *                            abort             = nullptr,
+                               std::shared_ptr<vvc::ParameterSetCache> parameterSetCache = {});
+
+// The index for a segment file is stored next to it as "<segmentFile>.idx"
+QString getSegmentIndexFileName(const QString &segmentFileName);
+
+uint64_t calculateSegmentHash(const QByteArray &segmentData);
+
+// True if the index was built from exactly this segment data (same size and hash)
+bool isSegmentIndexValidForSegment(const SegmentIndex &index, const QByteArray &segmentData);
+
+bool writeSegmentIndexFile(const QString &fileName, const SegmentIndex &index);
+
+// Read an index file. Files with a wrong magic or version, and files with access units or parameter
+// sets that do not lie within the indexed segment, are rejected.
+std::optional<SegmentIndex> readSegmentIndexFile(const QString &fileName);
+
+} // namespace parser
@@ -55,8 +55,8 @@ using namespace vvc;
 namespace
 {
 
-BitrateEntry createBitrateEntryForAU(ParsingState &              parsingState,
-                                     std::optional<BitrateEntry> bitrateEntry)
+BitrateEntry createBitrateEntryForAU(const ParsingState::CurrentAU &au,
+                                     std::optional<BitrateEntry>     bitrateEntry)
 {
   BitrateEntry entry;
   if (bitrateEntry)
@@ -67,67 +67,74 @@ BitrateEntry createBitrateEntryForAU(ParsingState &              parsingState,
   }
   else
   {
-    entry.pts      = parsingState.currentAU.poc;
-    entry.dts      = int(parsingState.currentAU.counter);
+    entry.pts      = au.poc;
+    entry.dts      = int(au.counter);
     entry.duration = 1;
   }
-  entry.bitrate  = unsigned(parsingState.currentAU.sizeBytes);
-  entry.keyframe = parsingState.currentAU.isKeyframe;
+  entry.bitrate      = unsigned(au.sizeBytes);
+  entry.keyframe     = au.isKeyframe;
+  entry.temporalId   = au.temporalId;
+  entry.nonReference = au.isNonReference;
   return entry;
 }
 
-} // namespace
-
-Size AnnexBVVC::getSequenceSizeSamples() const
+// The parsing of a PPS depends on the active SPSs. Parameter sets from the cache are shared and the
+// cache keeps the dependencies of its entries alive, so the identity of the SPS objects identifies
+// their content.
+uint64_t getSPSDependencyKey(const SPSMap &spsMap)
 {
-  for (const auto &nal : this->nalUnitsForSeeking)
+  uint64_t key = 0;
+  for (const auto &entry : spsMap)
   {
-    if (nal->header.nal_unit_type == vvc::NalType::SPS_NUT)
-    {
-      auto sps = std::dynamic_pointer_cast<seq_parameter_set_rbsp>(nal->rbsp);
-      return Size(sps->get_max_width_cropping(), sps->get_max_height_cropping());
-    }
+    auto pointerValue = uint64_t(reinterpret_cast<uintptr_t>(entry.second.get()));
+    key               = key * 31 + (uint64_t(entry.first) ^ pointerValue);
   }
+  return key;
+}
 
-  return {};
+} // namespace
+
+template <typename RBSP>
+std::shared_ptr<RBSP> AnnexBVVC::getCachedParameterSet(NalType           nalType,
+                                                       const ByteVector &data,
+                                                       size_t            payloadOffset,
+                                                       uint64_t          dependencyKey)
+{
+  if (!this->parameterSetCache)
+    return {};
+  auto rbsp = this->parameterSetCache->find(nalType, data, payloadOffset, dependencyKey);
+  return std::dynamic_pointer_cast<RBSP>(rbsp);
+}
+
+Size AnnexBVVC::getSequenceSizeSamples() const
+{
+  if (!this->firstSPS)
+    return {};
+  return Size(this->firstSPS->get_max_width_cropping(), this->firstSPS->get_max_height_cropping());
 }
 
 PixelFormatYUV AnnexBVVC::getPixelFormat() const
 {
   // Get the subsampling and bit-depth from the sps
-  int  bitDepthY   = -1;
-  int  bitDepthC   = -1;
-  auto subsampling = Subsampling::UNKNOWN;
-  for (const auto &nal : this->nalUnitsForSeeking)
-  {
-    if (nal->header.nal_unit_type == vvc::NalType::SPS_NUT)
-    {
-      auto sps = std::dynamic_pointer_cast<seq_parameter_set_rbsp>(nal->rbsp);
-      if (sps->sps_chroma_format_idc == 0)
-        subsampling = Subsampling::YUV_400;
-      else if (sps->sps_chroma_format_idc == 1)
-        subsampling = Subsampling::YUV_420;
-      else if (sps->sps_chroma_format_idc == 2)
-        subsampling = Subsampling::YUV_422;
-      else if (sps->sps_chroma_format_idc == 3)
-        subsampling = Subsampling::YUV_444;
-
-      bitDepthY = sps->sps_bitdepth_minus8 + 8;
-      bitDepthC = sps->sps_bitdepth_minus8 + 8;
-    }
+  if (!this->firstSPS)
+    return {};
 
-    if (bitDepthY != -1 && bitDepthC != -1 && subsampling != Subsampling::UNKNOWN)
-    {
-      if (bitDepthY != bitDepthC)
-      {
-        // Different luma and chroma bit depths currently not supported
-        return {};
-      }
-      return PixelFormatYUV(subsampling, bitDepthY);
-    }
-  }
+  auto subsampling = Subsampling::UNKNOWN;
+  if (this->firstSPS->sps_chroma_format_idc == 0)
+    subsampling = Subsampling::YUV_400;
+  else if (this->firstSPS->sps_chroma_format_idc == 1)
+    subsampling = Subsampling::YUV_420;
+  else if (this->firstSPS->sps_chroma_format_idc == 2)
+    subsampling = Subsampling::YUV_422;
+  else if (this->firstSPS->sps_chroma_format_idc == 3)
+    subsampling = Subsampling::YUV_444;
+
+  if (subsampling == Subsampling::UNKNOWN)
+    return {};
 
-  return {};
+  // Luma and chroma always have the same bit depth in VVC
+  auto bitDepth = int(this->firstSPS->sps_bitdepth_minus8) + 8;
+  return PixelFormatYUV(subsampling, bitDepth);
 }
 
 std::optional<AnnexB::SeekData> AnnexBVVC::getSeekData(int iFrameNr)
@@ -137,111 +144,66 @@ std::optional<AnnexB::SeekData> AnnexBVVC::getSeekData(int iFrameNr)
 
   auto seekPOC = this->getFramePOC(unsigned(iFrameNr));
 
-  // Collect the active parameter sets
-  using NalMap = std::map<unsigned, std::shared_ptr<NalUnitVVC>>;
-  NalMap activeVPSNal;
-  NalMap activeSPSNal;
-  NalMap activePPSNal;
-  using ApsMap = std::map<std::pair<unsigned, unsigned>, std::shared_ptr<NalUnitVVC>>;
-  ApsMap activeAPSNal;
-
-  for (const auto &nal : this->nalUnitsForSeeking)
-  {
-    if (nal->header.isSlice())
-    {
-      auto slice = std::dynamic_pointer_cast<slice_layer_rbsp>(nal->rbsp);
-
-      auto picHeader = slice->slice_header_instance.picture_header_structure_instance;
-      if (!picHeader)
-      {
-        DEBUG_VVC("Error - Slice has no picture header");
-        continue;
-      }
-
-      if (seekPOC >= 0 && picHeader->globalPOC == unsigned(seekPOC))
-      {
-        // Seek here
-        AnnexB::SeekData seekData;
-        if (nal->filePosStartEnd)
-          seekData.filePos = nal->filePosStartEnd->first;
+  auto seekPoint = this->seekPoints.find(seekPOC);
+  if (seekPoint == this->seekPoints.end())
+    return {};
 
-        for (const auto &nalMap : {activeVPSNal, activeSPSNal, activePPSNal})
-        {
-          for (const auto &entry : nalMap)
-            seekData.parameterSets.push_back(entry.second->rawData);
-        }
-        for (const auto &aps : activeAPSNal)
-          seekData.parameterSets.push_back(aps.second->rawData);
+  AnnexB::SeekData seekData;
+  seekData.filePos = seekPoint->second.filePos;
+  for (const auto &parameterSet : seekPoint->second.parameterSets)
+    seekData.parameterSets.push_back(*parameterSet);
 
-        return seekData;
-      }
-    }
-    if (nal->header.nal_unit_type == NalType::VPS_NUT)
-    {
-      auto vps = std::dynamic_pointer_cast<video_parameter_set_rbsp>(nal->rbsp);
-      activeVPSNal[vps->vps_video_parameter_set_id] = nal;
-    }
-    if (nal->header.nal_unit_type == NalType::SPS_NUT)
-    {
-      auto sps = std::dynamic_pointer_cast<seq_parameter_set_rbsp>(nal->rbsp);
-      activeSPSNal[sps->sps_seq_parameter_set_id] = nal;
-    }
-    if (nal->header.nal_unit_type == NalType::PPS_NUT)
-    {
-      auto pps = std::dynamic_pointer_cast<pic_parameter_set_rbsp>(nal->rbsp);
-      activePPSNal[pps->pps_pic_parameter_set_id] = nal;
-    }
-    if (nal->header.nal_unit_type == NalType::PREFIX_APS_NUT ||
-        nal->header.nal_unit_type == NalType::SUFFIX_APS_NUT)
-    {
-      auto aps     = std::dynamic_pointer_cast<adaptation_parameter_set_rbsp>(nal->rbsp);
-      auto apsType = apsParamTypeMapper.indexOf(aps->aps_params_type);
-      activeAPSNal[{apsType, aps->aps_adaptation_parameter_set_id}] = nal;
-    }
-  }
-
-  return {};
+  return seekData;
 }
 
 QByteArray AnnexBVVC::getExtradata() { return {}; }
 
 IntPair AnnexBVVC::getProfileLevel()
 {
-  for (const auto &nal : this->nalUnitsForSeeking)
-  {
-    if (nal->header.nal_unit_type == vvc::NalType::SPS_NUT)
-    {
-      auto sps = std::dynamic_pointer_cast<seq_parameter_set_rbsp>(nal->rbsp);
-      return {sps->profile_tier_level_instance.general_profile_idc,
-              sps->profile_tier_level_instance.general_level_idc};
-    }
-  }
-  return {};
+  if (!this->firstSPS)
+    return {};
+  return {this->firstSPS->profile_tier_level_instance.general_profile_idc,
+          this->firstSPS->profile_tier_level_instance.general_level_idc};
 }
 
 Ratio AnnexBVVC::getSampleAspectRatio()
 {
-  for (const auto &nal : this->nalUnitsForSeeking)
+  if (this->firstSPS && this->firstSPS->sps_vui_parameters_present_flag)
   {
-    if (nal->header.nal_unit_type == vvc::NalType::SPS_NUT)
+    auto vui = this->firstSPS->vui_payload_instance.vui;
+    if (vui.vui_aspect_ratio_info_present_flag)
     {
-      auto sps = std::dynamic_pointer_cast<seq_parameter_set_rbsp>(nal->rbsp);
-      if (sps->sps_vui_parameters_present_flag)
-      {
-        auto vui = sps->vui_payload_instance.vui;
-        if (vui.vui_aspect_ratio_info_present_flag)
-        {
-          if (vui.vui_aspect_ratio_idc == 255)
-            return {int(vui.vui_sar_height), int(vui.vui_sar_width)};
-          else
-            return sampleAspectRatioCoding.getValue(vui.vui_aspect_ratio_idc);
-        }
-      }
+      if (vui.vui_aspect_ratio_idc == 255)
+        return {int(vui.vui_sar_height), int(vui.vui_sar_width)};
+      else
+        return sampleAspectRatioCoding.getValue(vui.vui_aspect_ratio_idc);
     }
   }
   return Ratio({1, 1});
 }
 
+void AnnexBVVC::addParameterSetForSeeking(ParameterSetKey key, const ByteVector &data)
+{
+  // Seek points that use the previous version keep it alive
+  auto &parameterSet = this->parameterSetsForSeeking[key];
+  if (!parameterSet || *parameterSet != data)
+    parameterSet = std::make_shared<const ByteVector>(data);
+}
+
+void AnnexBVVC::addSeekPoint(int poc, std::optional<pairUint64> nalStartEndPosFile)
+{
+  // Only the first slice of a picture is a seek point
+  if (this->seekPoints.count(poc) > 0)
+    return;
+
+  SeekPoint seekPoint;
+  if (nalStartEndPosFile)
+    seekPoint.filePos = nalStartEndPosFile->first;
+  for (const auto &[key, parameterSet] : this->parameterSetsForSeeking)
+    seekPoint.parameterSets.push_back(parameterSet);
+  this->seekPoints[poc] = std::move(seekPoint);
+}
+
 AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         nalID,
                                                   const ByteVector &          data,
                                                   std::optional<BitrateEntry> bitrateEntry,
@@ -254,8 +216,9 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
   {
     if (this->parsingState.currentAU.poc != -1)
     {
-      parseResult.bitrateEntry = createBitrateEntryForAU(this->parsingState, bitrateEntry);
-      if (!this->handleNewAU(this->parsingState))
+      parseResult.bitrateEntry =
+          createBitrateEntryForAU(this->parsingState.currentAU, bitrateEntry);
+      if (!this->handleNewAU(this->parsingState.currentAU))
       {
         DEBUG_VVC("Error handling last AU");
         parseResult.success = false;
@@ -287,9 +250,12 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
 
   reader::SubByteReaderLogging reader(data, nalRoot, "", readOffset);
 
+  // The parsing state is updated in place. Only the previous AU is needed in case this NAL starts
+  // a new one.
+  const auto previousAU = this->parsingState.currentAU;
+
   std::string specificDescription;
-  auto        nalVVC              = std::make_shared<vvc::NalUnitVVC>(nalID, nalStartEndPosFile);
-  auto        updatedParsingState = this->parsingState;
+  auto        nalVVC = makeShared<vvc::NalUnitVVC>(&this->arena, nalID, nalStartEndPosFile);
   try
   {
     nalVVC->header.parse(reader);
@@ -297,93 +263,130 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
     auto nalType        = nalVVC->header.nal_unit_type;
     specificDescription = " " + NalTypeMapper.getName(nalType);
 
-    if (updatedParsingState.NoOutputBeforeRecoveryFlag.count(nalVVC->header.nuh_layer_id) == 0)
-      updatedParsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id] = true;
+    if (this->parsingState.NoOutputBeforeRecoveryFlag.count(nalVVC->header.nuh_layer_id) == 0)
+      this->parsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id] = true;
 
     if (nalType == NalType::VPS_NUT)
     {
-      auto newVPS = std::make_shared<video_parameter_set_rbsp>();
-      newVPS->parse(reader);
+      auto newVPS =
+          this->getCachedParameterSet<video_parameter_set_rbsp>(nalType, data, readOffset, 0);
+      if (!newVPS)
+      {
+        newVPS = std::make_shared<video_parameter_set_rbsp>();
+        newVPS->parse(reader);
+        if (this->parameterSetCache)
+          this->parameterSetCache->add(nalType, data, readOffset, 0, newVPS);
+      }
 
       this->activeParameterSets.vpsMap[newVPS->vps_video_parameter_set_id] = newVPS;
 
       specificDescription += " ID " + std::to_string(newVPS->vps_video_parameter_set_id);
 
-      nalVVC->rbsp    = newVPS;
-      nalVVC->rawData = data;
-      this->nalUnitsForSeeking.push_back(nalVVC);
+      nalVVC->rbsp = newVPS;
+      this->addParameterSetForSeeking({nalType, newVPS->vps_video_parameter_set_id}, data);
     }
     else if (nalType == NalType::SPS_NUT)
     {
-      auto newSPS = std::make_shared<seq_parameter_set_rbsp>();
-      newSPS->parse(reader);
+      auto newSPS =
+          this->getCachedParameterSet<seq_parameter_set_rbsp>(nalType, data, readOffset, 0);
+      if (!newSPS)
+      {
+        newSPS = std::make_shared<seq_parameter_set_rbsp>();
+        newSPS->parse(reader);
+        if (this->parameterSetCache)
+          this->parameterSetCache->add(nalType, data, readOffset, 0, newSPS);
+      }
 
       this->activeParameterSets.spsMap[newSPS->sps_seq_parameter_set_id] = newSPS;
+      if (!this->firstSPS)
+        this->firstSPS = newSPS;
 
       specificDescription += " ID " + std::to_string(newSPS->sps_seq_parameter_set_id);
 
-      nalVVC->rbsp    = newSPS;
-      nalVVC->rawData = data;
-      this->nalUnitsForSeeking.push_back(nalVVC);
+      nalVVC->rbsp = newSPS;
+      this->addParameterSetForSeeking({nalType, newSPS->sps_seq_parameter_set_id}, data);
     }
     else if (nalType == NalType::PPS_NUT)
     {
-      auto newPPS = std::make_shared<pic_parameter_set_rbsp>();
-      newPPS->parse(reader, this->activeParameterSets.spsMap);
+      auto dependencyKey = getSPSDependencyKey(this->activeParameterSets.spsMap);
+      auto newPPS        = this->getCachedParameterSet<pic_parameter_set_rbsp>(
+          nalType, data, readOffset, dependencyKey);
+      if (!newPPS)
+      {
+        newPPS = std::make_shared<pic_parameter_set_rbsp>();
+        newPPS->parse(reader, this->activeParameterSets.spsMap);
+        if (this->parameterSetCache)
+        {
+          std::vector<std::shared_ptr<NalRBSP>> dependencies;
+          for (const auto &sps : this->activeParameterSets.spsMap)
+            dependencies.push_back(sps.second);
+          this->parameterSetCache->add(
+              nalType, data, readOffset, dependencyKey, newPPS, std::move(dependencies));
+        }
+      }
 
       this->activeParameterSets.ppsMap[newPPS->pps_pic_parameter_set_id] = newPPS;
 
       specificDescription += " ID " + std::to_string(newPPS->pps_pic_parameter_set_id);
 
-      nalVVC->rbsp    = newPPS;
-      nalVVC->rawData = data;
-      this->nalUnitsForSeeking.push_back(nalVVC);
+      nalVVC->rbsp = newPPS;
+      this->addParameterSetForSeeking({nalType, newPPS->pps_pic_parameter_set_id}, data);
     }
     else if (nalType == NalType::PREFIX_APS_NUT || nalType == NalType::SUFFIX_APS_NUT)
     {
-      auto newAPS = std::make_shared<adaptation_parameter_set_rbsp>();
-      newAPS->parse(reader);
+      auto newAPS =
+          this->getCachedParameterSet<adaptation_parameter_set_rbsp>(nalType, data, readOffset, 0);
+      if (!newAPS)
+      {
+        newAPS = std::make_shared<adaptation_parameter_set_rbsp>();
+        newAPS->parse(reader);
+        if (this->parameterSetCache)
+          this->parameterSetCache->add(nalType, data, readOffset, 0, newAPS);
+      }
 
       auto apsType = apsParamTypeMapper.indexOf(newAPS->aps_params_type);
       this->activeParameterSets.apsMap[{apsType, newAPS->aps_adaptation_parameter_set_id}] = newAPS;
 
       specificDescription += " ID " + std::to_string(newAPS->aps_adaptation_parameter_set_id);
 
-      nalVVC->rbsp    = newAPS;
-      nalVVC->rawData = data;
-      this->nalUnitsForSeeking.push_back(nalVVC);
+      nalVVC->rbsp = newAPS;
+
+      // Prefix and suffix APS share the same ID space per APS type
+      auto apsKey = (unsigned(apsType) << 8) | newAPS->aps_adaptation_parameter_set_id;
+      this->addParameterSetForSeeking({NalType::PREFIX_APS_NUT, apsKey}, data);
     }
     else if (nalType == NalType::PH_NUT)
     {
-      auto newPictureHeader = std::make_shared<picture_header_rbsp>();
+      auto newPictureHeader = makeShared<picture_header_rbsp>(&this->arena);
       newPictureHeader->parse(reader,
                               this->activeParameterSets.vpsMap,
                               this->activeParameterSets.spsMap,
                               this->activeParameterSets.ppsMap,
-                              updatedParsingState.currentSlice);
+                              this->parsingState.currentSlice,
+                              &this->arena);
       auto &pictureHeader = newPictureHeader->picture_header_structure_instance;
       pictureHeader->calculatePictureOrderCount(
           reader,
           nalType,
           this->activeParameterSets.spsMap,
           this->activeParameterSets.ppsMap,
-          updatedParsingState.prevTid0Pic[nalVVC->header.nuh_layer_id],
-          updatedParsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id]);
+          this->parsingState.prevTid0Pic[nalVVC->header.nuh_layer_id],
+          this->parsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id]);
 
-      updatedParsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id] = false;
+      this->parsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id] = false;
 
       pictureHeader->globalPOC =
           calculateAndUpdateGlobalPOC(isIRAP(nalType), pictureHeader->PicOrderCntVal);
 
-      updatedParsingState.currentPictureHeaderStructure =
+      this->parsingState.currentPictureHeaderStructure =
           newPictureHeader->picture_header_structure_instance;
-      updatedParsingState.currentAU.poc = pictureHeader->globalPOC;
+      this->parsingState.currentAU.poc = pictureHeader->globalPOC;
 
       // 8.3.1
       auto TemporalId = nalVVC->header.nuh_temporal_id_plus1 - 1;
       if (TemporalId == 0 && !pictureHeader->ph_non_ref_pic_flag && nalType != NalType::RASL_NUT &&
           nalType != NalType::RADL_NUT)
-        updatedParsingState.prevTid0Pic[nalVVC->header.nuh_layer_id] = pictureHeader;
+        this->parsingState.prevTid0Pic[nalVVC->header.nuh_layer_id] = pictureHeader;
 
       specificDescription += " POC " + std::to_string(pictureHeader->PicOrderCntVal);
 
@@ -392,15 +395,16 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
     else if (nalVVC->header.isSlice())
     {
       specificDescription += " (Slice Header)";
-      auto newSliceLayer = std::make_shared<slice_layer_rbsp>();
+      auto newSliceLayer = makeShared<slice_layer_rbsp>(&this->arena);
       newSliceLayer->parse(reader,
                            nalType,
                            this->activeParameterSets.vpsMap,
                            this->activeParameterSets.spsMap,
                            this->activeParameterSets.ppsMap,
-                           updatedParsingState.currentPictureHeaderStructure);
+                           this->parsingState.currentPictureHeaderStructure,
+                           &this->arena);
 
-      updatedParsingState.currentSlice = newSliceLayer;
+      this->parsingState.currentSlice = newSliceLayer;
       if (newSliceLayer->slice_header_instance.picture_header_structure_instance)
       {
         newSliceLayer->slice_header_instance.picture_header_structure_instance
@@ -409,20 +413,20 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
                 nalType,
                 this->activeParameterSets.spsMap,
                 this->activeParameterSets.ppsMap,
-                updatedParsingState.prevTid0Pic[nalVVC->header.nuh_layer_id],
-                updatedParsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id]);
+                this->parsingState.prevTid0Pic[nalVVC->header.nuh_layer_id],
+                this->parsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id]);
 
-        updatedParsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id] = false;
+        this->parsingState.NoOutputBeforeRecoveryFlag[nalVVC->header.nuh_layer_id] = false;
 
         newSliceLayer->slice_header_instance.picture_header_structure_instance->globalPOC =
             calculateAndUpdateGlobalPOC(isIRAP(nalType),
                                         newSliceLayer->slice_header_instance
                                             .picture_header_structure_instance->PicOrderCntVal);
 
-        updatedParsingState.currentPictureHeaderStructure =
+        this->parsingState.currentPictureHeaderStructure =
             newSliceLayer->slice_header_instance.picture_header_structure_instance;
-        updatedParsingState.currentAU.poc =
-            updatedParsingState.currentPictureHeaderStructure->globalPOC;
+        this->parsingState.currentAU.poc =
+            this->parsingState.currentPictureHeaderStructure->globalPOC;
 
         // 8.3.1
         auto TemporalId = nalVVC->header.nuh_temporal_id_plus1 - 1;
@@ -430,32 +434,33 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
             !newSliceLayer->slice_header_instance.picture_header_structure_instance
                  ->ph_non_ref_pic_flag &&
             nalType != NalType::RASL_NUT && nalType != NalType::RADL_NUT)
-          updatedParsingState.prevTid0Pic[nalVVC->header.nuh_layer_id] =
+          this->parsingState.prevTid0Pic[nalVVC->header.nuh_layer_id] =
               newSliceLayer->slice_header_instance.picture_header_structure_instance;
       }
       else
       {
-        if (!updatedParsingState.currentPictureHeaderStructure)
+        if (!this->parsingState.currentPictureHeaderStructure)
           throw std::logic_error("Slice must have a valid picture header");
         newSliceLayer->slice_header_instance.picture_header_structure_instance =
-            updatedParsingState.currentPictureHeaderStructure;
+            this->parsingState.currentPictureHeaderStructure;
       }
 
       specificDescription +=
-          " POC " + std::to_string(updatedParsingState.currentPictureHeaderStructure->globalPOC);
+          " POC " + std::to_string(this->parsingState.currentPictureHeaderStructure->globalPOC);
       specificDescription +=
           " " + to_string(newSliceLayer->slice_header_instance.sh_slice_type) + "-Slice";
 
       nalVVC->rbsp = newSliceLayer;
 
-      updatedParsingState.currentAU.isKeyframe =
+      this->parsingState.currentAU.isKeyframe =
           (nalType == NalType::IDR_W_RADL || nalType == NalType::IDR_N_LP ||
            nalType == NalType::CRA_NUT);
-      if (updatedParsingState.currentAU.isKeyframe)
-      {
-        nalVVC->rawData = data;
-        this->nalUnitsForSeeking.push_back(nalVVC);
-      }
+      this->parsingState.currentAU.temporalId = nalVVC->header.nuh_temporal_id_plus1 - 1;
+      this->parsingState.currentAU.isNonReference =
+          this->parsingState.currentPictureHeaderStructure->ph_non_ref_pic_flag;
+      if (this->parsingState.currentAU.isKeyframe)
+        this->addSeekPoint(this->parsingState.currentPictureHeaderStructure->globalPOC,
+                           nalStartEndPosFile);
     }
     else if (nalType == NalType::AUD_NUT)
     {
@@ -494,31 +499,28 @@ AnnexB::ParseResult AnnexBVVC::parseAndAddNALUnit(int                         na
   DEBUG_VVC("AnnexBVVC::parseAndAddNALUnit NAL " + QString::fromStdString(specificDescription));
 
   if (this->auDelimiterDetector.isStartOfNewAU(nalVVC,
-                                               updatedParsingState.currentPictureHeaderStructure))
+                                               this->parsingState.currentPictureHeaderStructure))
   {
-    auto &parsingStatePreviousAU = this->parsingState;
-    parseResult.bitrateEntry     = createBitrateEntryForAU(parsingStatePreviousAU, bitrateEntry);
-    if (!this->handleNewAU(parsingStatePreviousAU))
+    parseResult.bitrateEntry = createBitrateEntryForAU(previousAU, bitrateEntry);
+    if (!this->handleNewAU(previousAU))
     {
-      specificDescription += " ERROR Adding POC " +
-                             std::to_string(parsingStatePreviousAU.currentAU.poc) +
-                             " to frame list";
+      specificDescription +=
+          " ERROR Adding POC " + std::to_string(previousAU.poc) + " to frame list";
       parseResult.success = false;
     }
 
-    updatedParsingState.currentAU.fileStartEndPos = nalStartEndPosFile;
-    updatedParsingState.currentAU.sizeBytes       = 0;
-    updatedParsingState.currentAU.counter++;
+    this->parsingState.currentAU.fileStartEndPos = nalStartEndPosFile;
+    this->parsingState.currentAU.sizeBytes       = 0;
+    this->parsingState.currentAU.counter++;
   }
   else if (nalStartEndPosFile)
   {
-    if (updatedParsingState.currentAU.fileStartEndPos)
-      updatedParsingState.currentAU.fileStartEndPos->second = nalStartEndPosFile->second;
+    if (this->parsingState.currentAU.fileStartEndPos)
+      this->parsingState.currentAU.fileStartEndPos->second = nalStartEndPosFile->second;
     else
-      updatedParsingState.currentAU.fileStartEndPos = nalStartEndPosFile;
+      this->parsingState.currentAU.fileStartEndPos = nalStartEndPosFile;
   }
 
-  this->parsingState = updatedParsingState;
   this->parsingState.currentAU.sizeBytes += data.size();
 
   if (nalRoot)
@@ -544,25 +546,20 @@ int AnnexBVVC::calculateAndUpdateGlobalPOC(bool isIRAP, unsigned PicOrderCntVal)
   return poc;
 }
 
-bool AnnexBVVC::handleNewAU(ParsingState &parsingState)
+bool AnnexBVVC::handleNewAU(const ParsingState::CurrentAU &au)
 {
-  DEBUG_VVC("Start of new AU. Adding bitrate " << parsingState.currentAU.sizeBytes << " POC "
-                                               << parsingState.currentAU.poc << " AU "
-                                               << parsingState.currentAU.counter);
+  DEBUG_VVC("Start of new AU. Adding bitrate " << au.sizeBytes << " POC " << au.poc << " AU "
+                                               << au.counter);
 
-  if (!this->addFrameToList(parsingState.currentAU.poc,
-                            parsingState.currentAU.fileStartEndPos,
-                            parsingState.currentAU.isKeyframe))
+  if (!this->addFrameToList(au.poc, au.fileStartEndPos, au.isKeyframe))
     return false;
 
-  if (this->parsingState.currentAU.fileStartEndPos)
-    DEBUG_VVC("Adding start/end " << parsingState.currentAU.fileStartEndPos->first << "/"
-                                  << parsingState.currentAU.fileStartEndPos->second << " - AU "
-                                  << parsingState.currentAU.counter
-                                  << (parsingState.currentAU.isKeyframe ? " - ra" : ""));
+  if (au.fileStartEndPos)
+    DEBUG_VVC("Adding start/end " << au.fileStartEndPos->first << "/"
+                                  << au.fileStartEndPos->second << " - AU " << au.counter
+                                  << (au.isKeyframe ? " - ra" : ""));
   else
-    DEBUG_VVC("Adding start/end NA/NA - AU " << parsingState.currentAU.counter
-                                             << (parsingState.currentAU.isKeyframe ? " - ra" : ""));
+    DEBUG_VVC("Adding start/end NA/NA - AU " << au.counter << (au.isKeyframe ? " - ra" : ""));
 
   return true;
 }
@@ -25,10 +25,12 @@ SOFTWARE. */
 
 #include "../AnnexB.h"
 #include "NalUnitVVC.h"
+#include "ParameterSetCache.h"
 #include "commonMaps.h"
+#include <parser/common/ParsingArena.h>
 #include <video/PixelFormatYUV.h>
 
-
+#include <map>
 #include <memory>
 
 namespace parser
@@ -57,6 +59,8 @@ struct ParsingState
     size_t                    sizeBytes{};
     int                       poc{-1};
     bool                      isKeyframe{};
+    unsigned                  temporalId{};
+    bool                      isNonReference{};
     std::optional<pairUint64> fileStartEndPos;
   };
   CurrentAU currentAU{};
@@ -71,7 +75,8 @@ struct ParsingState
 class AnnexBVVC : public AnnexB
 {
 public:
-  AnnexBVVC() : AnnexB(){};
+  AnnexBVVC(std::shared_ptr<vvc::ParameterSetCache> parameterSetCache = {})
+      : AnnexB(), parameterSetCache(parameterSetCache){};
   ~AnnexBVVC() = default;
 
   // Get some properties
@@ -89,6 +94,10 @@ public:
                                  std::optional<pairUint64>   nalStartEndPosFile = {}) override;
 
 protected:
+  // Slices, picture headers and NAL units are allocated from this arena. It must be declared before
+  // all members that may hold these objects so that it is destroyed after them.
+  ParsingArena arena;
+
   // The PicOrderCntMsb may be reset to zero for IDR frames. In order to count the global POC, we
   // store the maximum POC.
   uint64_t maxPOCCount{0};
@@ -104,10 +113,37 @@ protected:
   };
   ActiveParameterSets activeParameterSets;
 
-  std::vector<std::shared_ptr<vvc::NalUnitVVC>> nalUnitsForSeeking;
+  // Parameter sets that were already parsed (possibly by another parser) are taken from the cache
+  std::shared_ptr<vvc::ParameterSetCache> parameterSetCache;
+  template <typename RBSP>
+  std::shared_ptr<RBSP> getCachedParameterSet(vvc::NalType      nalType,
+                                              const ByteVector &data,
+                                              size_t            payloadOffset,
+                                              uint64_t          dependencyKey);
+
+  // A compact index for seeking. For every keyframe the file position and the raw data of the
+  // parameter sets that were active at that point are saved. The raw data is shared between all
+  // seek points that use the same version of a parameter set, so a version is only kept once and
+  // only as long as a seek point needs it.
+  using ParameterSetKey  = std::pair<vvc::NalType, unsigned>;
+  using ParameterSetData = std::shared_ptr<const ByteVector>;
+  std::map<ParameterSetKey, ParameterSetData> parameterSetsForSeeking;
+  struct SeekPoint
+  {
+    std::optional<uint64_t>       filePos;
+    std::vector<ParameterSetData> parameterSets;
+  };
+  using GlobalPOC = int;
+  std::map<GlobalPOC, SeekPoint> seekPoints;
+
+  void addParameterSetForSeeking(ParameterSetKey key, const ByteVector &data);
+  void addSeekPoint(int poc, std::optional<pairUint64> nalStartEndPosFile);
+
+  // The properties of the sequence (size, format, ...) are taken from the first SPS
+  std::shared_ptr<vvc::seq_parameter_set_rbsp> firstSPS;
 
   vvc::ParsingState parsingState;
-  bool              handleNewAU(vvc::ParsingState &updatedParsingState);
+  bool              handleNewAU(const vvc::ParsingState::CurrentAU &au);
 
   struct auDelimiterDetector_t
   {
@@ -0,0 +1,135 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "ParameterSetCache.h"
+
+#include <algorithm>
+
+namespace parser::vvc
+{
+
+namespace
+{
+
+// APS may change with every picture. Limit the size of the cache so that it can not grow
+// indefinitely for long streams.
+constexpr size_t MAX_NR_CACHE_ENTRIES = 256;
+
+// FNV-1a over the payload
+uint64_t calculateKey(NalType           nalType,
+                      const ByteVector &data,
+                      size_t            payloadOffset,
+                      uint64_t          dependencyKey)
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  for (auto it = data.begin() + payloadOffset; it != data.end(); it++)
+  {
+    hash ^= uint64_t(*it);
+    hash *= 0x100000001b3;
+  }
+  hash ^= uint64_t(nalType) << 56;
+  hash ^= dependencyKey * 0x9e3779b97f4a7c15;
+  return hash;
+}
+
+bool isPayloadEqual(const ByteVector &payload, const ByteVector &data, size_t payloadOffset)
+{
+  if (payload.size() != data.size() - payloadOffset)
+    return false;
+  return std::equal(payload.begin(), payload.end(), data.begin() + payloadOffset);
+}
+
+} // namespace
+
+std::shared_ptr<NalRBSP> ParameterSetCache::find(NalType           nalType,
+                                                 const ByteVector &data,
+                                                 size_t            payloadOffset,
+                                                 uint64_t          dependencyKey)
+{
+  if (payloadOffset > data.size())
+    return {};
+
+  auto key = calculateKey(nalType, data, payloadOffset, dependencyKey);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto                        range = this->entries.equal_range(key);
+  for (auto it = range.first; it != range.second; it++)
+  {
+    const auto &entry = it->second;
+    if (entry.nalType == nalType && entry.dependencyKey == dependencyKey &&
+        isPayloadEqual(entry.payload, data, payloadOffset))
+    {
+      this->nrHits++;
+      return entry.rbsp;
+    }
+  }
+
+  this->nrMisses++;
+  return {};
+}
+
+void ParameterSetCache::add(NalType                               nalType,
+                            const ByteVector &                    data,
+                            size_t                                payloadOffset,
+                            uint64_t                              dependencyKey,
+                            std::shared_ptr<NalRBSP>              rbsp,
+                            std::vector<std::shared_ptr<NalRBSP>> dependencies)
+{
+  if (payloadOffset > data.size() || !rbsp)
+    return;
+
+  auto key = calculateKey(nalType, data, payloadOffset, dependencyKey);
+
+  Entry entry;
+  entry.nalType       = nalType;
+  entry.dependencyKey = dependencyKey;
+  entry.payload       = ByteVector(data.begin() + payloadOffset, data.end());
+  entry.rbsp          = rbsp;
+  entry.dependencies  = std::move(dependencies);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  while (this->entries.size() >= MAX_NR_CACHE_ENTRIES && !this->insertionOrder.empty())
+    this->removeOldestEntry();
+
+  entry.insertionCounter = this->insertionCounter++;
+  this->insertionOrder.emplace_back(key, entry.insertionCounter);
+  this->entries.emplace(key, std::move(entry));
+}
+
+void ParameterSetCache::removeOldestEntry()
+{
+  const auto [key, counter] = this->insertionOrder.front();
+  this->insertionOrder.pop_front();
+
+  auto range = this->entries.equal_range(key);
+  for (auto it = range.first; it != range.second; it++)
+  {
+    if (it->second.insertionCounter == counter)
+    {
+      this->entries.erase(it);
+      return;
+    }
+  }
+}
+
+} // namespace parser::vvc
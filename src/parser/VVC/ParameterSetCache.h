@@ -0,0 +1,95 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include "NalUnitVVC.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace parser::vvc
+{
+
+/* A cache for parsed parameter sets (VPS, SPS, PPS and APS).
+ *
+ * Every segment repeats the same parameter sets. Instead of parsing them again for every segment,
+ * the parsed parameter sets are stored in this cache keyed by a checksum over the NAL unit
+ * payload. Since a checksum can collide, the payload is also compared byte by byte on a hit. Some
+ * parameter sets (the PPS) are parsed using other parameter sets. For these a dependency key must
+ * be given which identifies the parameter sets that the result depends on. These dependencies are
+ * kept alive by the cache entry.
+ *
+ * The cache can be shared between multiple parsers (e.g. one parser per segment). If the cache is
+ * full, the oldest entry is removed.
+ */
+class ParameterSetCache
+{
+public:
+  ParameterSetCache() = default;
+
+  std::shared_ptr<NalRBSP> find(NalType           nalType,
+                                const ByteVector &data,
+                                size_t            payloadOffset,
+                                uint64_t          dependencyKey = 0);
+  void                     add(NalType                               nalType,
+                               const ByteVector &                    data,
+                               size_t                                payloadOffset,
+                               uint64_t                              dependencyKey,
+                               std::shared_ptr<NalRBSP>              rbsp,
+                               std::vector<std::shared_ptr<NalRBSP>> dependencies = {});
+
+  size_t getNrHits() const { return this->nrHits; }
+  size_t getNrMisses() const { return this->nrMisses; }
+
+private:
+  struct Entry
+  {
+    NalType                  nalType{};
+    uint64_t                 dependencyKey{};
+    ByteVector               payload;
+    std::shared_ptr<NalRBSP> rbsp;
+
+    std::vector<std::shared_ptr<NalRBSP>> dependencies;
+
+    uint64_t insertionCounter{};
+  };
+  std::unordered_multimap<uint64_t, Entry> entries;
+
+  // The key and insertion counter of all entries from the oldest to the newest
+  std::deque<std::pair<uint64_t, uint64_t>> insertionOrder;
+  uint64_t                                  insertionCounter{};
+
+  void removeOldestEntry();
+
+  std::mutex mutex;
+
+  // Read without the lock (e.g. for the status display)
+  std::atomic<size_t> nrHits{};
+  std::atomic<size_t> nrMisses{};
+};
+
+} // namespace parser::vvc
@@ -76,6 +76,29 @@ bool isIRAP(NalType nal_unit_type)
          nal_unit_type == NalType::CRA_NUT;
 }
 
+bool isParameterSet(NalType nal_unit_type)
+{
+  return nal_unit_type == NalType::VPS_NUT || nal_unit_type == NalType::SPS_NUT ||
+         nal_unit_type == NalType::PPS_NUT || nal_unit_type == NalType::PREFIX_APS_NUT ||
+         nal_unit_type == NalType::SUFFIX_APS_NUT;
+}
+
+std::optional<NalType> getNalTypeFromRawData(const char *data, size_t size)
+{
+  size_t offset = 0;
+  if (size > 3 && data[0] == char(0) && data[1] == char(0) && data[2] == char(1))
+    offset = 3;
+  else if (size > 4 && data[0] == char(0) && data[1] == char(0) && data[2] == char(0) &&
+           data[3] == char(1))
+    offset = 4;
+
+  // The nal_unit_type is in the upper 5 bits of the second header byte
+  if (size < offset + 2)
+    return {};
+  auto nalUnitTypeID = (static_cast<unsigned char>(data[offset + 1]) >> 3) & 0x1f;
+  return nalTypeCoding.getValue(nalUnitTypeID);
+}
+
 void nal_unit_header::parse(SubByteReaderLogging &reader)
 {
   SubByteReaderLoggingSubLevel subLevel(reader, "nal_unit_header");
@@ -102,6 +102,11 @@ const EnumMapper<NalType> NalTypeMapper({{NalType::TRAIL_NUT, "TRAIL_NUT"},
 
 // 3.1
 bool isIRAP(NalType nal_unit_type);
+bool isParameterSet(NalType nal_unit_type);
+
+// Get the nal_unit_type from the raw NAL data (which may start with a start code) by only looking
+// at the header bytes. This is much cheaper than setting up a reader and parsing the header.
+std::optional<NalType> getNalTypeFromRawData(const char *data, size_t size);
 
 class nal_unit_header
 {
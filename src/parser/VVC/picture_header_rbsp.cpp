@@ -32,16 +32,17 @@ namespace parser::vvc
 
 using namespace parser::reader;
 
-void picture_header_rbsp::parse(SubByteReaderLogging &                 reader,
+void picture_header_rbsp::parse(SubByteReaderLogging &            reader,
                                 VPSMap &                          vpsMap,
                                 SPSMap &                          spsMap,
                                 PPSMap &                          ppsMap,
-                                std::shared_ptr<slice_layer_rbsp> sl)
+                                std::shared_ptr<slice_layer_rbsp> sl,
+                                ParsingArena *                    arena)
 {
   SubByteReaderLoggingSubLevel subLevel(reader, "picture_header_rbsp");
 
-  this->picture_header_structure_instance = std::make_shared<picture_header_structure>();
-  this->picture_header_structure_instance->parse(reader, vpsMap, spsMap, ppsMap, sl);
+  this->picture_header_structure_instance = makeShared<picture_header_structure>(arena);
+  this->picture_header_structure_instance->parse(reader, vpsMap, spsMap, ppsMap, sl, arena);
   this->rbsp_trailing_bits_instance.parse(reader);
 }
 
@@ -25,6 +25,7 @@ SOFTWARE. */
 
 #include "NalUnitVVC.h"
 #include "commonMaps.h"
+#include "parser/common/ParsingArena.h"
 #include "parser/common/SubByteReaderLogging.h"
 #include "picture_header_structure.h"
 #include "rbsp_trailing_bits.h"
@@ -39,11 +40,12 @@ class picture_header_rbsp : public NalRBSP
 public:
   picture_header_rbsp()  = default;
   ~picture_header_rbsp() = default;
-  void parse(reader::SubByteReaderLogging &         reader,
+  void parse(reader::SubByteReaderLogging &    reader,
              VPSMap &                          vpsMap,
              SPSMap &                          spsMap,
              PPSMap &                          ppsMap,
-             std::shared_ptr<slice_layer_rbsp> sl);
+             std::shared_ptr<slice_layer_rbsp> sl,
+             ParsingArena *                    arena = nullptr);
 
   std::shared_ptr<picture_header_structure> picture_header_structure_instance;
   rbsp_trailing_bits                        rbsp_trailing_bits_instance;
@@ -45,7 +45,8 @@ void picture_header_structure::parse(SubByteReaderLogging &            reader,
                                      VPSMap &                          vpsMap,
                                      SPSMap &                          spsMap,
                                      PPSMap &                          ppsMap,
-                                     std::shared_ptr<slice_layer_rbsp> sl)
+                                     std::shared_ptr<slice_layer_rbsp> sl,
+                                     ParsingArena *                    arena)
 {
   SubByteReaderLoggingSubLevel subLevel(reader, "picture_header_structure");
 
@@ -202,7 +203,7 @@ void picture_header_structure::parse(SubByteReaderLogging &            reader,
   }
   if (pps->pps_rpl_info_in_ph_flag)
   {
-    this->ref_pic_lists_instance = std::make_shared<ref_pic_lists>();
+    this->ref_pic_lists_instance = makeShared<ref_pic_lists>(arena);
     this->ref_pic_lists_instance->parse(reader, sps, pps);
   }
   if (sps->sps_partition_constraints_override_enabled_flag)
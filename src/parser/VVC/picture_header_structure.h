@@ -25,6 +25,7 @@ SOFTWARE. */
 
 #include "NalUnitVVC.h"
 #include "commonMaps.h"
+#include "parser/common/ParsingArena.h"
 #include "parser/common/SubByteReaderLogging.h"
 #include "pred_weight_table.h"
 #include "ref_pic_lists.h"
@@ -47,7 +48,8 @@ public:
              VPSMap &                          vpsMap,
              SPSMap &                          spsMap,
              PPSMap &                          ppsMap,
-             std::shared_ptr<slice_layer_rbsp> sl);
+             std::shared_ptr<slice_layer_rbsp> sl,
+             ParsingArena *                    arena = nullptr);
 
   void calculatePictureOrderCount(reader::SubByteReaderLogging &            reader,
                                   NalType                                   nalType,
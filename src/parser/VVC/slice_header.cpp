@@ -49,7 +49,8 @@ void slice_header::parse(SubByteReaderLogging &                    reader,
                          SPSMap &                                  spsMap,
                          PPSMap &                                  ppsMap,
                          std::shared_ptr<slice_layer_rbsp>         sliceLayer,
-                         std::shared_ptr<picture_header_structure> picHeader)
+                         std::shared_ptr<picture_header_structure> picHeader,
+                         ParsingArena *                            arena)
 {
   SubByteReaderLoggingSubLevel subLevel(reader, "slice_header");
 
@@ -57,8 +58,9 @@ void slice_header::parse(SubByteReaderLogging &                    reader,
       reader.readFlag("sh_picture_header_in_slice_header_flag");
   if (this->sh_picture_header_in_slice_header_flag)
   {
-    this->picture_header_structure_instance = std::make_shared<picture_header_structure>();
-    this->picture_header_structure_instance->parse(reader, vpsMap, spsMap, ppsMap, sliceLayer);
+    this->picture_header_structure_instance = makeShared<picture_header_structure>(arena);
+    this->picture_header_structure_instance->parse(
+        reader, vpsMap, spsMap, ppsMap, sliceLayer, arena);
     picHeader = this->picture_header_structure_instance;
   }
 
@@ -184,7 +186,7 @@ void slice_header::parse(SubByteReaderLogging &                    reader,
         reader.readFlag("sh_explicit_scaling_list_used_flag");
   }
 
-  this->ref_pic_lists_instance = std::make_shared<ref_pic_lists>();
+  this->ref_pic_lists_instance = makeShared<ref_pic_lists>(arena);
 
   if (!pps->pps_rpl_info_in_ph_flag &&
       ((nal_unit_type != NalType::IDR_W_RADL && nal_unit_type != NalType::IDR_N_LP) ||
@@ -25,6 +25,7 @@ SOFTWARE. */
 
 #include "NalUnitVVC.h"
 #include "byte_alignment.h"
+#include "parser/common/ParsingArena.h"
 #include "parser/common/SubByteReaderLogging.h"
 #include "picture_header_structure.h"
 #include "pred_weight_table.h"
@@ -55,7 +56,8 @@ public:
              SPSMap &                                  spsMap,
              PPSMap &                                  ppsMap,
              std::shared_ptr<slice_layer_rbsp>         sliceLayer,
-             std::shared_ptr<picture_header_structure> picHeader);
+             std::shared_ptr<picture_header_structure> picHeader,
+             ParsingArena *                            arena = nullptr);
 
   bool                                      sh_picture_header_in_slice_header_flag{};
   std::shared_ptr<picture_header_structure> picture_header_structure_instance;
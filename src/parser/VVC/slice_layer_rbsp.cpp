@@ -28,16 +28,18 @@ namespace parser::vvc
 
 using namespace parser::reader;
 
-void slice_layer_rbsp::parse(reader::SubByteReaderLogging &                 reader,
+void slice_layer_rbsp::parse(reader::SubByteReaderLogging &            reader,
                              NalType                                   nal_unit_type,
                              VPSMap &                                  vpsMap,
                              SPSMap &                                  spsMap,
                              PPSMap &                                  ppsMap,
-                             std::shared_ptr<picture_header_structure> picHeader)
+                             std::shared_ptr<picture_header_structure> picHeader,
+                             ParsingArena *                            arena)
 {
   SubByteReaderLoggingSubLevel subLevel(reader, "slice_layer_rbsp");
 
-  this->slice_header_instance.parse(reader, nal_unit_type, vpsMap, spsMap, ppsMap, shared_from_this(), picHeader);
+  this->slice_header_instance.parse(
+      reader, nal_unit_type, vpsMap, spsMap, ppsMap, shared_from_this(), picHeader, arena);
 
   // The rest is arithmetically coded
   // this->slice_data_instance.parse(reader);
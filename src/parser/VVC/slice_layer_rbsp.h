@@ -25,6 +25,7 @@ SOFTWARE. */
 
 #include "NalUnitVVC.h"
 #include "commonMaps.h"
+#include "parser/common/ParsingArena.h"
 #include "parser/common/SubByteReaderLogging.h"
 #include "slice_header.h"
 #include "picture_header_structure.h"
@@ -37,12 +38,13 @@ class slice_layer_rbsp : public NalRBSP, public std::enable_shared_from_this<sli
 public:
   slice_layer_rbsp()  = default;
   ~slice_layer_rbsp() = default;
-  void parse(reader::SubByteReaderLogging &                 reader,
+  void parse(reader::SubByteReaderLogging &            reader,
              NalType                                   nal_unit_type,
              VPSMap &                                  vpsMap,
              SPSMap &                                  spsMap,
              PPSMap &                                  ppsMap,
-             std::shared_ptr<picture_header_structure> picHeader);
+             std::shared_ptr<picture_header_structure> picHeader,
+             ParsingArena *                            arena = nullptr);
 
   slice_header slice_header_instance;
 
@@ -0,0 +1,96 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "ParsingArena.h"
+
+#include <algorithm>
+
+namespace parser
+{
+
+ParsingArena::ParsingArena(size_t blockSize) : blockSize(blockSize) {}
+
+void *ParsingArena::allocate(size_t nrBytes, size_t alignment)
+{
+  void *position = this->currentPosition;
+  if (position == nullptr ||
+      std::align(alignment, nrBytes, position, this->remainingBytesInBlock) == nullptr)
+  {
+    this->startBlock(nrBytes + alignment);
+    position = this->currentPosition;
+    std::align(alignment, nrBytes, position, this->remainingBytesInBlock);
+  }
+
+  this->currentPosition = static_cast<char *>(position) + nrBytes;
+  this->remainingBytesInBlock -= nrBytes;
+  this->nrBytesAllocated += nrBytes;
+  this->blocks[this->currentBlock].nrLiveAllocations++;
+  return position;
+}
+
+void ParsingArena::deallocate(void *position)
+{
+  // There are only a few blocks. The most recent ones are the most likely to contain the position.
+  const auto bytePosition = static_cast<char *>(position);
+  for (auto i = this->blocks.size(); i > 0; i--)
+  {
+    auto &block = this->blocks[i - 1];
+    if (bytePosition < block.data.get() || bytePosition >= block.data.get() + block.size)
+      continue;
+
+    block.nrLiveAllocations--;
+    if (block.nrLiveAllocations == 0 && i - 1 == this->currentBlock)
+    {
+      // Start over at the beginning of the current block
+      this->currentPosition       = block.data.get();
+      this->remainingBytesInBlock = block.size;
+    }
+    return;
+  }
+}
+
+void ParsingArena::startBlock(size_t minimumSize)
+{
+  for (size_t i = 0; i < this->blocks.size(); i++)
+  {
+    const auto &block = this->blocks[i];
+    if (i != this->currentBlock && block.nrLiveAllocations == 0 && block.size >= minimumSize)
+    {
+      this->currentBlock          = i;
+      this->currentPosition       = block.data.get();
+      this->remainingBytesInBlock = block.size;
+      return;
+    }
+  }
+
+  Block block;
+  block.size = std::max(this->blockSize, minimumSize);
+  block.data = std::unique_ptr<char[]>(new char[block.size]);
+
+  this->blocks.push_back(std::move(block));
+  this->currentBlock          = this->blocks.size() - 1;
+  this->currentPosition       = this->blocks.back().data.get();
+  this->remainingBytesInBlock = this->blocks.back().size;
+}
+
+} // namespace parser
@@ -0,0 +1,125 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace parser
+{
+
+/* A simple arena for the many small syntax structures that are created while parsing.
+ *
+ * Memory is taken from large blocks. Each block counts the allocations in it that are still alive.
+ * Once all objects in a block are destroyed (e.g. the slices and picture headers of an AU after the
+ * next AU was started), the block is reused for new allocations. So the memory use is bounded by
+ * the objects that are alive and does not grow with the length of the stream. All blocks are freed
+ * together when the arena is destroyed, so all objects that were allocated from the arena must be
+ * destroyed before the arena is. The arena is not thread safe.
+ */
+class ParsingArena
+{
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  explicit ParsingArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+  ~ParsingArena() = default;
+
+  ParsingArena(const ParsingArena &) = delete;
+  ParsingArena &operator=(const ParsingArena &) = delete;
+
+  void *allocate(size_t nrBytes, size_t alignment);
+  void  deallocate(void *position);
+
+  size_t getNrBytesAllocated() const { return this->nrBytesAllocated; }
+  size_t getNrBlocks() const { return this->blocks.size(); }
+
+private:
+  struct Block
+  {
+    std::unique_ptr<char[]> data;
+    size_t                  size{};
+    size_t                  nrLiveAllocations{};
+  };
+
+  // Switch to a block without live allocations that is large enough or add a new one
+  void startBlock(size_t minimumSize);
+
+  std::vector<Block> blocks;
+
+  size_t blockSize{};
+  size_t currentBlock{};
+  char * currentPosition{};
+  size_t remainingBytesInBlock{};
+  size_t nrBytesAllocated{};
+};
+
+// A std compatible allocator that takes its memory from a ParsingArena
+template <typename T> class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(ParsingArena *arena) noexcept : arena(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena(other.getArena())
+  {
+  }
+
+  T *allocate(std::size_t n)
+  {
+    return static_cast<T *>(this->arena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *p, std::size_t) noexcept { this->arena->deallocate(p); }
+
+  ParsingArena *getArena() const noexcept { return this->arena; }
+
+private:
+  ParsingArena *arena{};
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+  return lhs.getArena() == rhs.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+// Create a shared object (including the control block) in the arena. If no arena is given, the
+// object is created on the heap.
+template <typename T, typename... Args>
+std::shared_ptr<T> makeShared(ParsingArena *arena, Args &&... args)
+{
+  if (arena == nullptr)
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+}
+
+} // namespace parser
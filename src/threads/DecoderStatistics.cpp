@@ -0,0 +1,131 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "DecoderStatistics.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+DecoderStatistics::DecoderStatistics() : creationTime(std::chrono::steady_clock::now()) {}
+
+void DecoderStatistics::addPicture(const PictureRecord &record) { this->pictures.push(record); }
+
+void DecoderStatistics::addSegment(const SegmentRecord &record) { this->segments.push(record); }
+
+void DecoderStatistics::addWaitTime(int64_t waitUs) { this->totalWaitUs += waitUs; }
+
+int64_t DecoderStatistics::getTimestampUs(std::chrono::steady_clock::time_point time) const
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(time - this->creationTime).count();
+}
+
+DecoderStatistics::Snapshot DecoderStatistics::getSnapshot() const
+{
+  Snapshot snapshot;
+  snapshot.nrPictures  = this->pictures.count();
+  snapshot.nrSegments  = this->segments.count();
+  snapshot.totalWaitUs = this->totalWaitUs;
+  snapshot.pictures    = this->pictures.read();
+  snapshot.segments    = this->segments.read();
+  return snapshot;
+}
+
+QString DecoderStatistics::toCSV(const std::vector<Snapshot> &snapshots)
+{
+  // One table for all records. Fields that don't apply to a record type are left empty.
+  QString csv = "Type,Instance,Segment,Rendition,Frame,NrFrames,LatencyUs,TimestampUs,QueueUs,"
+                "WaitUs,DecodeUs,FPS\n";
+  for (const auto &snapshot : snapshots)
+  {
+    for (const auto &picture : snapshot.pictures)
+      csv += QString("Picture,%1,%2,%3,%4,,%5,%6,,,,\n")
+                 .arg(snapshot.instance)
+                 .arg(picture.segmentNumber)
+                 .arg(picture.rendition)
+                 .arg(picture.frameIdx)
+                 .arg(picture.latencyUs)
+                 .arg(picture.timestampUs);
+    for (const auto &segment : snapshot.segments)
+      csv += QString("Segment,%1,%2,%3,,%4,,,%5,%6,%7,%8\n")
+                 .arg(snapshot.instance)
+                 .arg(segment.segmentNumber)
+                 .arg(segment.rendition)
+                 .arg(segment.nrFrames)
+                 .arg(segment.queueUs)
+                 .arg(segment.waitUs)
+                 .arg(segment.decodeUs)
+                 .arg(segment.fps, 0, 'f', 2);
+  }
+  return csv;
+}
+
+QString DecoderStatistics::toJSON(const std::vector<Snapshot> &snapshots)
+{
+  QJsonArray decoders;
+  for (const auto &snapshot : snapshots)
+  {
+    QJsonObject decoder;
+    decoder["Instance"]    = int(snapshot.instance);
+    decoder["DecoderInfo"] = snapshot.decoderInfo;
+    decoder["DecodingFPS"] = snapshot.decodingFPS;
+    decoder["NrPictures"]  = qint64(snapshot.nrPictures);
+    decoder["NrSegments"]  = qint64(snapshot.nrSegments);
+    decoder["TotalWaitUs"] = qint64(snapshot.totalWaitUs);
+
+    QJsonArray pictures;
+    for (const auto &picture : snapshot.pictures)
+    {
+      QJsonObject pictureObject;
+      pictureObject["Segment"]     = int(picture.segmentNumber);
+      pictureObject["Rendition"]   = int(picture.rendition);
+      pictureObject["Frame"]       = int(picture.frameIdx);
+      pictureObject["LatencyUs"]   = qint64(picture.latencyUs);
+      pictureObject["TimestampUs"] = qint64(picture.timestampUs);
+      pictures.append(pictureObject);
+    }
+    decoder["Pictures"] = pictures;
+
+    QJsonArray segments;
+    for (const auto &segment : snapshot.segments)
+    {
+      QJsonObject segmentObject;
+      segmentObject["Segment"]   = int(segment.segmentNumber);
+      segmentObject["Rendition"] = int(segment.rendition);
+      segmentObject["NrFrames"]  = int(segment.nrFrames);
+      segmentObject["QueueUs"]   = qint64(segment.queueUs);
+      segmentObject["WaitUs"]    = qint64(segment.waitUs);
+      segmentObject["DecodeUs"]  = qint64(segment.decodeUs);
+      segmentObject["FPS"]       = segment.fps;
+      segments.append(segmentObject);
+    }
+    decoder["Segments"] = segments;
+
+    decoders.append(decoder);
+  }
+
+  QJsonObject root;
+  root["Decoders"] = decoders;
+  return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
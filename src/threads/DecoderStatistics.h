@@ -0,0 +1,172 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/* Statistics of one decoder thread.
+ *
+ * Recording never blocks the decoder: Records go into fixed size ring buffers (the oldest records
+ * are overwritten) and the counters are atomics. Readers get a snapshot which only contains
+ * completely written records. A record is dropped if its slot is still being written by a writer
+ * that is a whole ring behind.
+ */
+class DecoderStatistics
+{
+public:
+  DecoderStatistics();
+
+  struct PictureRecord
+  {
+    unsigned segmentNumber{};
+    unsigned rendition{};
+    unsigned frameIdx{};
+    // From pushing the access unit at this position in the segment to the output of the picture
+    int64_t latencyUs{};
+    // The time of the output relative to the creation of the statistics
+    int64_t timestampUs{};
+  };
+
+  struct SegmentRecord
+  {
+    unsigned segmentNumber{};
+    unsigned rendition{};
+    unsigned nrFrames{};
+    int64_t  queueUs{};  // From the end of parsing to the start of decoding
+    int64_t  waitUs{};   // How long the decoder was blocked waiting for the segment
+    int64_t  decodeUs{}; // From pushing the first access unit to the output of the last picture
+    double   fps{};
+  };
+
+  struct Snapshot
+  {
+    unsigned instance{};
+    QString  decoderInfo;
+    double   decodingFPS{};
+    uint64_t nrPictures{};
+    uint64_t nrSegments{};
+    int64_t  totalWaitUs{};
+
+    std::vector<PictureRecord> pictures;
+    std::vector<SegmentRecord> segments;
+  };
+
+  void addPicture(const PictureRecord &record);
+  void addSegment(const SegmentRecord &record);
+  void addWaitTime(int64_t waitUs);
+
+  int64_t  getTimestampUs(std::chrono::steady_clock::time_point time) const;
+  Snapshot getSnapshot() const;
+
+  static QString toCSV(const std::vector<Snapshot> &snapshots);
+  static QString toJSON(const std::vector<Snapshot> &snapshots);
+
+private:
+  // Each slot has a sequence number which is odd while the slot is written. Writers only
+  // increment the write counter, so multiple threads can push without locking. The record is
+  // stored in relaxed atomic words so that a reader which races with a writer does not read it
+  // non-atomically. The reader discards the copy if the sequence number changed meanwhile.
+  template <typename Record, size_t Size> class RecordRing
+  {
+  public:
+    static_assert(std::is_trivially_copyable_v<Record>);
+
+    void push(const Record &record)
+    {
+      auto  index = this->writeCounter.fetch_add(1, std::memory_order_relaxed);
+      auto &slot  = this->ringSlots[index % Size];
+
+      // Reserve the slot. If another writer is still writing to it (from a previous lap) or a
+      // writer from a later lap already took it, the record is dropped instead of overtaking it.
+      auto sequence = slot.sequence.load(std::memory_order_relaxed);
+      do
+      {
+        if (sequence % 2 == 1 || sequence >= 2 * index + 1)
+          return;
+      } while (!slot.sequence.compare_exchange_weak(
+          sequence, 2 * index + 1, std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_release);
+
+      std::array<uint64_t, NR_WORDS> words{};
+      std::memcpy(words.data(), &record, sizeof(Record));
+      for (size_t i = 0; i < NR_WORDS; i++)
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+
+      slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    std::vector<Record> read() const
+    {
+      auto                end   = this->writeCounter.load(std::memory_order_acquire);
+      auto                start = (end > Size) ? end - Size : 0;
+      std::vector<Record> records;
+      records.reserve(end - start);
+      for (auto index = start; index < end; index++)
+      {
+        const auto &slot     = this->ringSlots[index % Size];
+        auto        sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2)
+          continue;
+
+        std::array<uint64_t, NR_WORDS> words{};
+        for (size_t i = 0; i < NR_WORDS; i++)
+          words[i] = slot.words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+          continue;
+
+        Record record;
+        std::memcpy(static_cast<void *>(&record), words.data(), sizeof(Record));
+        records.push_back(record);
+      }
+      return records;
+    }
+
+    uint64_t count() const { return this->writeCounter.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr size_t NR_WORDS = (sizeof(Record) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+      std::atomic<uint64_t>                       sequence{0};
+      std::array<std::atomic<uint64_t>, NR_WORDS> words{};
+    };
+    std::array<Slot, Size> ringSlots{};
+    std::atomic<uint64_t>  writeCounter{0};
+  };
+
+  RecordRing<PictureRecord, 4096> pictures;
+  RecordRing<SegmentRecord, 256>  segments;
+  std::atomic<int64_t>            totalWaitUs{0};
+
+  std::chrono::steady_clock::time_point creationTime;
+};
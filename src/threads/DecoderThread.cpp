@@ -24,11 +24,11 @@ SOFTWARE. */
 #include "DecoderThread.h"
 
 #include <common/functions.h>
-#include <decoder/decoderVVDec.h>
+#include <decoder/DecoderFactory.h>
 #include <parser/VVC/nal_unit_header.h>
-#include <parser/common/SubByteReaderLogging.h>
 
 #include <QDebug>
+#include <algorithm>
 #include <chrono>
 
 #define DEBUG_DECODER_MANAGER 0
@@ -42,39 +42,83 @@ SOFTWARE. */
 namespace
 {
 
-bool isSPSNAL(QByteArray nalData)
+// Only the NAL unit header is inspected. No copy or parsing of the data is needed.
+bool isSPSNAL(const QByteArray &nalData)
 {
-  auto data = convertToByteVector(nalData);
+  auto nalType = parser::vvc::getNalTypeFromRawData(nalData.constData(), size_t(nalData.size()));
+  return nalType && *nalType == parser::vvc::NalType::SPS_NUT;
+}
+
+// If the access unit contains an SPS, return a copy of the access unit in which the SPS is
+// replaced. Otherwise the access unit is returned unchanged.
+QByteArray replaceSPSInAccessUnit(const QByteArray &accessUnit, const QByteArray &newSPS)
+{
+  QByteArray newAccessUnit;
+  bool       spsReplaced = false;
+
+  auto nalStart = findNextNalInData(accessUnit, 0);
+  while (nalStart)
+  {
+    auto nextNalStart = findNextNalInData(accessUnit, *nalStart + 3);
+    auto nalEnd       = nextNalStart ? *nextNalStart : size_t(accessUnit.size());
+    auto nalData =
+        QByteArray::fromRawData(accessUnit.constData() + *nalStart, int(nalEnd - *nalStart));
+
+    if (isSPSNAL(nalData))
+    {
+      newAccessUnit.append(newSPS);
+      spsReplaced = true;
+    }
+    else
+      newAccessUnit.append(nalData);
+
+    nalStart = nextNalStart;
+  }
+
+  return spsReplaced ? newAccessUnit : accessUnit;
+}
 
-  // Skip the NAL unit header
-  int readOffset = 0;
-  if (data.size() > 3 && data.at(0) == (char)0 && data.at(1) == (char)0 && data.at(2) == (char)1)
-    readOffset = 3;
-  else if (data.size() > 4 && data.at(0) == (char)0 && data.at(1) == (char)0 &&
-           data.at(2) == (char)0 && data.at(3) == (char)1)
-    readOffset = 4;
+// The CTS of each access unit identifies the segment (upper 32 bits) and the index of the access
+// unit in the segment. vvdec passes the CTS on to the decoded picture.
+uint64_t makeCTS(uint32_t segmentTag, unsigned accessUnitIdx)
+{
+  return (uint64_t(segmentTag) << 32) | accessUnitIdx;
+}
 
-  parser::reader::SubByteReaderLogging reader(data, {}, "", readOffset);
-  parser::vvc::nal_unit_header         header;
-  header.parse(reader);
+std::pair<uint32_t, unsigned> splitCTS(uint64_t cts)
+{
+  return {uint32_t(cts >> 32), unsigned(cts & 0xffffffff)};
+}
 
-  return header.nal_unit_type == parser::vvc::NalType::SPS_NUT;
+// The frame in which the picture of the access unit is stored (see Segment::frames)
+unsigned getDisplayIndex(const Segment &segment, unsigned accessUnitIdx)
+{
+  return segment.displayIndexOfAccessUnit.at(accessUnitIdx);
 }
 
 } // namespace
 
-DecoderThread::DecoderThread(ILogger *logger, SegmentBuffer *segmentBuffer)
-    : logger(logger), segmentBuffer(segmentBuffer)
+DecoderThread::DecoderThread(ILogger *                       logger,
+                             SegmentBuffer *                 segmentBuffer,
+                             const decoder::DecoderSettings &decoderSettings,
+                             SegmentMode                     segmentMode)
+    : logger(logger), segmentBuffer(segmentBuffer), decoderSettings(decoderSettings)
 {
-  this->decoder = std::make_unique<decoder::decoderVVDec>();
-  if (this->decoder->errorInDecoder())
-  {
-    this->logger->addMessage("Error in decoder: " + this->decoder->decoderErrorString(),
-                             LoggingPriority::Error);
+  this->decoder = this->createDecoder();
+  if (!this->decoder)
     return;
-  }
-
-  this->decoderThread = std::thread(&DecoderThread::runDecoder, this);
+  this->effectiveDecoderSettings = this->decoder->getEffectiveSettings();
+  this->decoderInfo              = this->decoder->getDecoderInfo();
+
+  // Only sequential decoding switches between renditions with one decoder
+  if (segmentMode == SegmentMode::Sequential)
+    if (auto spareDecoder = this->createDecoder())
+      this->spareDecoders.push_back(std::move(spareDecoder));
+
+  if (segmentMode == SegmentMode::Independent)
+    this->decoderThread = std::thread(&DecoderThread::runIndependentSegmentDecoder, this);
+  else
+    this->decoderThread = std::thread(&DecoderThread::runDecoder, this);
 }
 
 DecoderThread::~DecoderThread()
@@ -82,10 +126,17 @@ DecoderThread::~DecoderThread()
   this->abort();
   if (this->decoderThread.joinable())
     this->decoderThread.join();
+  if (this->drainThread.joinable())
+    this->drainThread.join();
 }
 
 void DecoderThread::abort() { this->decoderAbort = true; }
 
+void DecoderThread::setNrTemporalLayersToSkip(unsigned nrLayers)
+{
+  this->nrTemporalLayersToSkip = nrLayers;
+}
+
 void DecoderThread::setOpenGopAdaptiveResolutionChange(bool adaptiveResolutioChange)
 {
   this->adaptiveResolutioChange = adaptiveResolutioChange;
@@ -93,7 +144,32 @@ void DecoderThread::setOpenGopAdaptiveResolutionChange(bool adaptiveResolutioCha
 
 QString DecoderThread::getStatus() const
 {
-  return (this->decoderAbort ? "Abort " : "") + this->statusText;
+  auto status = (this->decoderAbort ? "Abort " : "") + this->statusText;
+  status += QString(" %1 fps").arg(this->getDecodingFPS(), 0, 'f', 1);
+  if (this->nrFramesSkipped > 0)
+    status += QString(" skipped %1").arg(this->nrFramesSkipped.load());
+  auto switchLatencyUs = this->lastSwitchLatencyUs.load();
+  if (switchLatencyUs >= 0)
+    status += QString(" last switch %1 ms").arg(double(switchLatencyUs) / 1000.0, 0, 'f', 1);
+  if (!this->effectiveDecoderSettings.isEmpty())
+    status += " (" + this->effectiveDecoderSettings + ")";
+  return status;
+}
+
+double DecoderThread::getDecodingFPS() const
+{
+  auto durationUs = this->decodingDurationUs.load();
+  if (durationUs == 0)
+    return 0.0;
+  return double(this->nrFramesDecoded) * 1000000.0 / double(durationUs);
+}
+
+DecoderStatistics::Snapshot DecoderThread::getStatistics() const
+{
+  auto snapshot        = this->statistics.getSnapshot();
+  snapshot.decoderInfo = this->decoderInfo;
+  snapshot.decodingFPS = this->getDecodingFPS();
+  return snapshot;
 }
 
 void DecoderThread::onDownloadOfFirstSPSSegmentFinished(QByteArray segmentData)
@@ -137,46 +213,54 @@ void DecoderThread::runDecoder()
 {
   this->logger->addMessage("Started decoder thread", LoggingPriority::Info);
 
-  size_t                currentDataOffset        = 0;
-  unsigned              currentFrameIdxInSegment = 0;
-  auto                  itSegmentData            = this->segmentBuffer->getFirstSegmentToDecode();
-  std::queue<Segment *> nextSegmentFrames;
-  nextSegmentFrames.push(itSegmentData);
+  unsigned nextAccessUnitToPush = 0;
+
+  this->setDecoding(false);
+  auto itSegmentData = this->segmentBuffer->getFirstSegmentToDecode();
+  if (!itSegmentData)
+    return;
+  this->setDecoding(true);
+
+  SegmentsInDecoder segmentsInDecoder;
+  auto              segmentTag = this->addSegmentToDecoder(segmentsInDecoder, itSegmentData);
 
   while (!this->decoderAbort)
   {
-    const auto &data                     = itSegmentData->compressedData;
-    bool        resetDecoderAfterSegment = false;
-
-    if (auto firstPos = findNextNalInData(data, 0))
-      currentDataOffset = *firstPos;
+    nextAccessUnitToPush = 0;
     while (!this->decoderAbort)
     {
       auto state = this->decoder->state();
 
       if (state == decoder::DecoderState::NeedsMoreData)
       {
-        QByteArray nalData;
-        if (auto nextNalStart = findNextNalInData(data, currentDataOffset + 3))
-        {
-          auto length       = *nextNalStart - currentDataOffset;
-          nalData           = data.mid(currentDataOffset, length);
-          currentDataOffset = *nextNalStart;
-        }
-        else if (currentDataOffset < size_t(data.size()))
+        // Push one complete access unit (using the AU boundaries from the parser) at a time
+        if (nextAccessUnitToPush < itSegmentData->frames.size())
         {
-          nalData           = data.mid(currentDataOffset);
-          currentDataOffset = data.size();
-        }
+          auto accessUnitIdx = nextAccessUnitToPush++;
+          auto auData        = this->getAccessUnitData(*itSegmentData, accessUnitIdx);
+          if (auData.isEmpty() || this->skipAccessUnit(*itSegmentData, accessUnitIdx))
+          {
+            this->dropAccessUnit(*itSegmentData, accessUnitIdx);
+            continue;
+          }
 
-        if (nalData.isEmpty())
+          DEBUG("Pushing AU with " << auData.size() << " bytes");
+          this->onAccessUnitPushed(*itSegmentData, accessUnitIdx);
+          if (!this->decoder->pushData(auData, makeCTS(segmentTag, accessUnitIdx)))
+          {
+            this->logger->addMessage("Error pushing data", LoggingPriority::Error);
+            break;
+          }
+        }
+        else
         {
           DEBUG("No more data. Will continue with next segment.");
 
+          this->setDecoding(false);
+
           // This may block until another segment to decode is available
-          this->statusText = "Waiting";
           auto nextSegment = this->segmentBuffer->getNextSegmentToDecode(itSegmentData);
-          this->statusText = "Decoding";
+          this->setDecoding(true);
 
           if (!nextSegment)
           {
@@ -192,36 +276,21 @@ void DecoderThread::runDecoder()
           auto renditionSwitch =
               nextSegment->segmentInfo.rendition != itSegmentData->segmentInfo.rendition;
 
-          itSegmentData = nextSegment;
-          nextSegmentFrames.push(nextSegment);
-
           if (renditionSwitch && !this->adaptiveResolutioChange)
           {
-            resetDecoderAfterSegment = true;
-            DEBUG("Pushing empty data (EOF)");
-            if (!this->decoder->pushData(nalData))
-            {
-              this->logger->addMessage("Error pushing empty data (EOF)", LoggingPriority::Error);
-              break;
-            }
-          }
-          else
-            break;
-        }
-        else
-        {
-          if (!this->highestRenditionSPS.isEmpty() && isSPSNAL(nalData))
-          {
-            DEBUG("Replace SPS with SPS from highest rendition");
-            nalData = this->highestRenditionSPS;
+            this->switchStart         = std::chrono::steady_clock::now();
+            this->switchTargetSegment = nextSegment;
+
+            // The old decoder is drained in the background while the next segment is already
+            // decoded by another decoder.
+            if (!this->startDrainingDecoder(std::move(segmentsInDecoder)))
+              return;
+            segmentsInDecoder = SegmentsInDecoder();
           }
 
-          DEBUG("Pushing " << nalData.size() << " bytes");
-          if (!this->decoder->pushData(nalData))
-          {
-            this->logger->addMessage("Error pushing data", LoggingPriority::Error);
-            break;
-          }
+          itSegmentData = nextSegment;
+          segmentTag    = this->addSegmentToDecoder(segmentsInDecoder, itSegmentData);
+          break;
         }
       }
 
@@ -230,58 +299,32 @@ void DecoderThread::runDecoder()
         DEBUG("Checking for next frame ");
         if (this->decoder->decodeNextFrame())
         {
-          auto itSegmentFrames = nextSegmentFrames.front();
-          if (currentFrameIdxInSegment >= itSegmentFrames->frames.size())
+          auto segment = this->storeDecodedFrame(segmentsInDecoder, *this->decoder);
+          if (segment != nullptr && segment == this->switchTargetSegment)
           {
-            nextSegmentFrames.pop();
-            if (nextSegmentFrames.empty())
-            {
-              this->logger->addMessage(
-                  QString(
-                      "Error putting frame %1 into buffer. Got more frames then there should be.")
-                      .arg(currentFrameIdxInSegment),
-                  LoggingPriority::Error);
-              break;
-            }
-            else
-            {
-              itSegmentFrames          = nextSegmentFrames.front();
-              currentFrameIdxInSegment = 0;
-              if (itSegmentFrames->frames.empty())
-              {
-                this->logger->addMessage(QString("Next segment has no frames"),
-                                         LoggingPriority::Error);
-                break;
-              }
-            }
+            auto latency = std::chrono::steady_clock::now() - this->switchStart;
+            this->lastSwitchLatencyUs =
+                std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+            this->switchTargetSegment = nullptr;
+            DEBUG("Rendition switch latency " << this->lastSwitchLatencyUs << "us");
           }
-
-          auto &frame       = itSegmentFrames->frames.at(currentFrameIdxInSegment);
-          frame->rawYUVData  = this->decoder->getRawFrameData();
-          frame->pixelFormat = this->decoder->getPixelFormatYUV();
-          frame->frameSize   = this->decoder->getFrameSize();
-          frame->frameState  = FrameState::Decoded;
-
-          DEBUG(QString("Saving frame (%1x%2) into frame idx %3 segment %4 rendition %5")
-                    .arg(frame->frameSize.width)
-                    .arg(frame->frameSize.height)
-                    .arg(currentFrameIdxInSegment)
-                    .arg(itSegmentFrames->segmentInfo.segmentNumber)
-                    .arg(itSegmentFrames->segmentInfo.rendition));
-          this->segmentBuffer->onFrameDecoded();
-          currentFrameIdxInSegment++;
         }
       }
 
       if (state == decoder::DecoderState::Error)
       {
+        // Drop what is still missing and continue with the next segment using a new decoder
         DEBUG("Decoding error");
-        this->logger->addMessage(QString("Error decoding rend %1 seg %2 frame %3")
+        this->logger->addMessage(QString("Error decoding rend %1 seg %2: %3")
                                      .arg(itSegmentData->segmentInfo.rendition)
                                      .arg(itSegmentData->segmentInfo.segmentNumber)
-                                     .arg(currentFrameIdxInSegment),
+                                     .arg(this->decoder->decoderErrorString()),
                                  LoggingPriority::Error);
-        break;
+        for (auto &segmentInDecoder : segmentsInDecoder)
+          this->dropUnfinishedFrames(segmentInDecoder.second);
+        segmentsInDecoder.clear();
+        this->decoder->resetDecoder();
+        nextAccessUnitToPush = unsigned(itSegmentData->frames.size());
       }
 
       if (state == decoder::DecoderState::EndOfBitstream)
@@ -295,10 +338,389 @@ void DecoderThread::runDecoder()
       return;
 
     DEBUG("Start decoding of next segment");
-    if (resetDecoderAfterSegment)
+  }
+}
+
+uint32_t DecoderThread::addSegmentToDecoder(SegmentsInDecoder &segmentsInDecoder,
+                                            Segment *          segment)
+{
+  auto segmentTag = this->nextSegmentTag++;
+  segmentsInDecoder[segmentTag] = {segment, segment->generation.load()};
+
+  // Temporal sub-layer 0 is always decoded
+  this->maxTemporalIdToDecode.reset();
+  if (auto nrLayersToSkip = this->nrTemporalLayersToSkip.load(); nrLayersToSkip > 0)
+  {
+    unsigned maxTemporalId = 0;
+    for (const auto &frame : segment->frames)
+      maxTemporalId = std::max(maxTemporalId, frame->temporalId);
+    this->maxTemporalIdToDecode =
+        (maxTemporalId > nrLayersToSkip) ? maxTemporalId - nrLayersToSkip : 0;
+  }
+
+  // Pictures that did not come out of the decoder by now are lost
+  while (segmentsInDecoder.size() > NR_SEGMENTS_IN_DECODER)
+  {
+    this->dropUnfinishedFrames(segmentsInDecoder.begin()->second);
+    segmentsInDecoder.erase(segmentsInDecoder.begin());
+  }
+
+  return segmentTag;
+}
+
+Segment *DecoderThread::storeDecodedFrame(SegmentsInDecoder &   segmentsInDecoder,
+                                          decoder::decoderBase &frameDecoder)
+{
+  auto cts = frameDecoder.getFrameCTS();
+  if (!cts)
+  {
+    this->logger->addMessage("Decoded frame without CTS is dropped", LoggingPriority::Error);
+    return {};
+  }
+
+  auto [segmentTag, accessUnitIdx] = splitCTS(*cts);
+  auto segmentIt                   = segmentsInDecoder.find(segmentTag);
+  if (segmentIt == segmentsInDecoder.end() ||
+      accessUnitIdx >= segmentIt->second.segment->frames.size())
+  {
+    this->logger->addMessage(QString("Decoded frame with unknown CTS %1 is dropped").arg(*cts),
+                             LoggingPriority::Error);
+    return {};
+  }
+
+  auto &segment  = *segmentIt->second.segment;
+  auto  frameIdx = getDisplayIndex(segment, accessUnitIdx);
+  if (segment.frames.at(frameIdx)->frameState != FrameState::Empty)
+  {
+    this->logger->addMessage(QString("Decoded frame %1 of segment %2 was already set")
+                                 .arg(frameIdx)
+                                 .arg(segment.segmentInfo.segmentNumber),
+                             LoggingPriority::Error);
+    return {};
+  }
+
+  DEBUG(QString("Saving frame (AU %1) into frame idx %2 segment %3 rendition %4")
+            .arg(accessUnitIdx)
+            .arg(frameIdx)
+            .arg(segment.segmentInfo.segmentNumber)
+            .arg(segment.segmentInfo.rendition));
+  this->storeDecodedFrame(segment, accessUnitIdx, frameIdx, frameDecoder);
+  return &segment;
+}
+
+void DecoderThread::dropAccessUnit(Segment &segment, unsigned accessUnitIdx)
+{
+  auto &frame   = *segment.frames.at(getDisplayIndex(segment, accessUnitIdx));
+  frame.dropped = true;
+  this->segmentBuffer->onFrameDecoded(frame);
+}
+
+void DecoderThread::dropUnfinishedFrames(const SegmentInDecoder &segmentInDecoder)
+{
+  if (this->segmentBuffer->dropUnfinishedFrames(*segmentInDecoder.segment,
+                                                segmentInDecoder.generation))
+    this->recordSegmentIfFinished(*segmentInDecoder.segment);
+}
+
+bool DecoderThread::startDrainingDecoder(SegmentsInDecoder segmentsInDecoder)
+{
+  // Only one decoder is drained at a time
+  if (this->drainThread.joinable())
+    this->drainThread.join();
+
+  std::unique_ptr<decoder::decoderBase> nextDecoder;
+  {
+    std::unique_lock lock(this->spareDecodersMutex);
+    if (!this->spareDecoders.empty())
+    {
+      nextDecoder = std::move(this->spareDecoders.back());
+      this->spareDecoders.pop_back();
+    }
+  }
+  if (!nextDecoder)
+  {
+    DEBUG("No spare decoder available. Open a new one.");
+    nextDecoder = this->createDecoder();
+    if (!nextDecoder)
+      return false;
+  }
+
+  this->drainThread = std::thread(&DecoderThread::drainDecoder,
+                                  this,
+                                  std::move(this->decoder),
+                                  std::move(segmentsInDecoder));
+  this->decoder     = std::move(nextDecoder);
+  return true;
+}
+
+void DecoderThread::drainDecoder(std::unique_ptr<decoder::decoderBase> drainingDecoder,
+                                 SegmentsInDecoder                     segmentsInDecoder)
+{
+  DEBUG("Pushing empty data (EOF)");
+  QByteArray emptyData;
+  if (!drainingDecoder->pushData(emptyData))
+    this->logger->addMessage("Error pushing empty data (EOF)", LoggingPriority::Error);
+
+  while (!this->decoderAbort && drainingDecoder->state() == decoder::DecoderState::RetrieveFrames)
+  {
+    if (drainingDecoder->decodeNextFrame())
+      this->storeDecodedFrame(segmentsInDecoder, *drainingDecoder);
+  }
+
+  if (drainingDecoder->state() == decoder::DecoderState::Error)
+    this->logger->addMessage("Error draining decoder: " + drainingDecoder->decoderErrorString(),
+                             LoggingPriority::Error);
+  DEBUG("Draining of decoder finished");
+
+  for (auto &segmentInDecoder : segmentsInDecoder)
+    this->dropUnfinishedFrames(segmentInDecoder.second);
+
+  if (this->decoderAbort)
+    return;
+
+  // The decoder is reopened here so that the decoder thread gets it back ready to use
+  DEBUG("Reopen drained decoder");
+  drainingDecoder->resetDecoder();
+  if (drainingDecoder->errorInDecoder())
+  {
+    this->logger->addMessage("Error reopening decoder: " + drainingDecoder->decoderErrorString(),
+                             LoggingPriority::Error);
+    return;
+  }
+
+  std::unique_lock lock(this->spareDecodersMutex);
+  this->spareDecoders.push_back(std::move(drainingDecoder));
+}
+
+void DecoderThread::runIndependentSegmentDecoder()
+{
+  this->logger->addMessage("Started independent segment decoder thread", LoggingPriority::Info);
+
+  while (!this->decoderAbort)
+  {
+    // This may block until another segment to decode is available
+    this->setDecoding(false);
+    auto segment = this->segmentBuffer->claimNextSegmentToDecode();
+    if (segment == nullptr)
     {
-      DEBUG("Reset decoder");
-      this->decoder->resetDecoder();
+      DEBUG("Got no segment to decode. Exit decoder thread.");
+      return;
     }
+    this->setDecoding(true);
+
+    // A claimed segment can not be displayed and recycled before its frames are decoded or dropped
+    auto generation = segment->generation.load();
+
+    DEBUG(QString("Claimed Rendition %1 Segment %2")
+              .arg(segment->segmentInfo.rendition)
+              .arg(segment->segmentInfo.segmentNumber));
+
+    if (!this->decodeIndependentSegment(*segment))
+      this->logger->addMessage(QString("Error decoding rend %1 seg %2")
+                                   .arg(segment->segmentInfo.rendition)
+                                   .arg(segment->segmentInfo.segmentNumber),
+                               LoggingPriority::Error);
+    this->dropUnfinishedFrames({segment, generation});
+
+    // The next segment must not depend on anything from this segment
+    this->decoder->resetDecoder();
+  }
+}
+
+bool DecoderThread::decodeIndependentSegment(Segment &segment)
+{
+  SegmentsInDecoder segmentsInDecoder;
+  auto              segmentTag           = this->addSegmentToDecoder(segmentsInDecoder, &segment);
+  unsigned          nextAccessUnitToPush = 0;
+
+  while (!this->decoderAbort)
+  {
+    auto state = this->decoder->state();
+
+    if (state == decoder::DecoderState::NeedsMoreData)
+    {
+      // After the last access unit, the empty data flushes the decoder
+      QByteArray              auData;
+      std::optional<uint64_t> cts;
+      if (nextAccessUnitToPush < segment.frames.size())
+      {
+        auto accessUnitIdx = nextAccessUnitToPush++;
+        auData             = this->getAccessUnitData(segment, accessUnitIdx);
+        if (auData.isEmpty() || this->skipAccessUnit(segment, accessUnitIdx))
+        {
+          this->dropAccessUnit(segment, accessUnitIdx);
+          continue;
+        }
+        this->onAccessUnitPushed(segment, accessUnitIdx);
+        cts = makeCTS(segmentTag, accessUnitIdx);
+      }
+
+      DEBUG("Pushing AU with " << auData.size() << " bytes");
+      if (!this->decoder->pushData(auData, cts))
+      {
+        this->logger->addMessage("Error pushing data", LoggingPriority::Error);
+        return false;
+      }
+    }
+    else if (state == decoder::DecoderState::RetrieveFrames)
+    {
+      if (this->decoder->decodeNextFrame())
+        this->storeDecodedFrame(segmentsInDecoder, *this->decoder);
+    }
+    else if (state == decoder::DecoderState::EndOfBitstream)
+    {
+      DEBUG("Decoding of segment finished");
+      return true;
+    }
+    else
+      return false;
+  }
+
+  return false;
+}
+
+QByteArray DecoderThread::getAccessUnitData(const Segment &segment, unsigned accessUnitIdx) const
+{
+  const auto &data  = segment.compressedData;
+  const auto &frame = segment.frames.at(accessUnitIdx);
+
+  if (frame->compressedDataOffset + frame->nrBytesCompressed > size_t(data.size()))
+  {
+    this->logger->addMessage(QString("Access unit %1 of segment %2 exceeds the segment data")
+                                 .arg(accessUnitIdx)
+                                 .arg(segment.segmentInfo.segmentNumber),
+                             LoggingPriority::Error);
+    return {};
+  }
+
+  // Reference the data in the segment without copying it
+  auto auData = QByteArray::fromRawData(data.constData() + frame->compressedDataOffset,
+                                        int(frame->nrBytesCompressed));
+
+  if (this->highestRenditionSPS.isEmpty())
+    return auData;
+
+  DEBUG("Replace SPS with SPS from highest rendition");
+  return replaceSPSInAccessUnit(auData, this->highestRenditionSPS);
+}
+
+bool DecoderThread::skipAccessUnit(const Segment &segment, unsigned accessUnitIdx)
+{
+  const auto &frame = *segment.frames.at(accessUnitIdx);
+  if (this->maxTemporalIdToDecode && frame.temporalId > *this->maxTemporalIdToDecode)
+    return true;
+
+  auto threshold = this->decoderSettings.skipNonReferenceThreshold.value_or(0);
+  if (threshold <= 0 || !frame.nonReference)
+    return false;
+  if (this->segmentBuffer->getNrOfFramesReadyAhead() >= unsigned(threshold))
+    return false;
+
+  DEBUG("Skipping non-reference AU " << accessUnitIdx);
+  this->nrFramesSkipped++;
+  return true;
+}
+
+void DecoderThread::onAccessUnitPushed(Segment &segment, unsigned accessUnitIdx)
+{
+  auto now = std::chrono::steady_clock::now();
+  segment.frames.at(accessUnitIdx)->pushedToDecoderTime = now;
+  if (accessUnitIdx == 0)
+  {
+    segment.decodingStartTime = now;
+    segment.decoderWaitUs     = this->lastWaitUs;
+  }
+}
+
+void DecoderThread::storeDecodedFrame(Segment &              segment,
+                                      unsigned               accessUnitIdx,
+                                      unsigned               frameIdx,
+                                      decoder::decoderBase &frameDecoder)
+{
+  using namespace std::chrono;
+
+  auto &frame       = *segment.frames.at(frameIdx);
+  frame.rawYUVData  = frameDecoder.getRawFrameData();
+  frame.pixelFormat = frameDecoder.getPixelFormatYUV();
+  frame.frameSize   = frameDecoder.getFrameSize();
+
+  this->nrFramesDecoded++;
+  this->segmentBuffer->onFrameDecoded(frame);
+
+  auto now        = steady_clock::now();
+  auto pushedTime = segment.frames.at(accessUnitIdx)->pushedToDecoderTime;
+
+  DecoderStatistics::PictureRecord picture;
+  picture.segmentNumber = segment.segmentInfo.segmentNumber;
+  picture.rendition     = segment.segmentInfo.rendition;
+  picture.frameIdx      = frameIdx;
+  picture.latencyUs     = duration_cast<microseconds>(now - pushedTime).count();
+  picture.timestampUs   = this->statistics.getTimestampUs(now);
+  this->statistics.addPicture(picture);
+
+  this->recordSegmentIfFinished(segment);
+}
+
+void DecoderThread::recordSegmentIfFinished(Segment &segment)
+{
+  using namespace std::chrono;
+
+  auto segmentFinished =
+      std::all_of(segment.frames.begin(), segment.frames.end(), [](const auto &segmentFrame) {
+        return segmentFrame->frameState != FrameState::Empty;
+      });
+  if (!segmentFinished || segment.decodingRecorded.exchange(true))
+    return;
+  // All frames were dropped before any access unit of the segment was pushed to a decoder
+  if (segment.decodingStartTime == steady_clock::time_point())
+    return;
+
+  auto now = steady_clock::now();
+
+  DecoderStatistics::SegmentRecord segmentRecord;
+  segmentRecord.segmentNumber = segment.segmentInfo.segmentNumber;
+  segmentRecord.rendition     = segment.segmentInfo.rendition;
+  segmentRecord.nrFrames      = unsigned(segment.frames.size());
+  segmentRecord.queueUs       = std::max(
+      duration_cast<microseconds>(segment.decodingStartTime - segment.parsingFinishedTime).count(),
+      int64_t(0));
+  segmentRecord.waitUs   = segment.decoderWaitUs;
+  segmentRecord.decodeUs = duration_cast<microseconds>(now - segment.decodingStartTime).count();
+  if (segmentRecord.decodeUs > 0)
+    segmentRecord.fps = double(segmentRecord.nrFrames) * 1000000.0 / segmentRecord.decodeUs;
+  this->statistics.addSegment(segmentRecord);
+}
+
+void DecoderThread::setDecoding(bool decoding)
+{
+  using namespace std::chrono;
+
+  auto now = steady_clock::now();
+  if (decoding && !this->decoding)
+  {
+    this->lastWaitUs = duration_cast<microseconds>(now - this->waitingStart).count();
+    this->statistics.addWaitTime(this->lastWaitUs);
+    this->decodingStart = now;
+  }
+  else if (!decoding)
+  {
+    if (this->decoding)
+      this->decodingDurationUs += duration_cast<microseconds>(now - this->decodingStart).count();
+    this->waitingStart = now;
+  }
+
+  this->decoding   = decoding;
+  this->statusText = decoding ? "Decoding" : "Waiting";
+}
+
+std::unique_ptr<decoder::decoderBase> DecoderThread::createDecoder()
+{
+  auto newDecoder = decoder::createDecoder(this->decoderSettings);
+  if (newDecoder->errorInDecoder())
+  {
+    this->logger->addMessage("Error in decoder: " + newDecoder->decoderErrorString(),
+                             LoggingPriority::Error);
+    return {};
   }
+  return newDecoder;
 }
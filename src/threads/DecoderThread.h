@@ -23,12 +23,19 @@ SOFTWARE. */
 
 #pragma once
 
+#include "DecoderStatistics.h"
+
 #include <SegmentBuffer.h>
 #include <common/ILogger.h>
+#include <decoder/DecoderSettings.h>
 #include <decoder/decoderBase.h>
 
 #include <QObject>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <thread>
 
@@ -37,14 +44,36 @@ class DecoderThread : public QObject
   Q_OBJECT
 
 public:
-  DecoderThread(ILogger *logger, SegmentBuffer *segmentBuffer);
+  enum class SegmentMode
+  {
+    // Decode all segments in order with one decoder. Needed for open GOP segments.
+    Sequential,
+    // Claim whole segments from the buffer and decode each of them separately (the decoder is
+    // reset after each segment). Multiple threads in this mode can decode in parallel.
+    Independent
+  };
+
+  DecoderThread(ILogger *                       logger,
+                SegmentBuffer *                 segmentBuffer,
+                const decoder::DecoderSettings &decoderSettings,
+                SegmentMode                     segmentMode = SegmentMode::Sequential);
   ~DecoderThread();
   void abort();
 
   void setOpenGopAdaptiveResolutionChange(bool adaptiveResolutioChange);
 
+  // For trick play, the given number of the highest temporal sub-layers is not decoded. A change
+  // takes effect with the next segment because sub-layers can only be added back at the IRAP
+  // picture at the start of a segment.
+  void setNrTemporalLayersToSkip(unsigned nrLayers);
+
   QString getStatus() const;
 
+  // The decoding speed. Time spent waiting for segments is not counted.
+  double getDecodingFPS() const;
+
+  DecoderStatistics::Snapshot getStatistics() const;
+
 public slots:
   void onDownloadOfFirstSPSSegmentFinished(QByteArray segmentData);
 
@@ -53,14 +82,87 @@ private:
   SegmentBuffer *segmentBuffer{};
 
   void runDecoder();
-
+  void runIndependentSegmentDecoder();
+  bool decodeIndependentSegment(Segment &segment);
+
+  // The segments that have access units in a decoder by the tag that is part of the CTS. The
+  // generation of the segment is kept to detect that the segment was recycled in the meantime.
+  struct SegmentInDecoder
+  {
+    Segment *segment{};
+    uint64_t generation{};
+  };
+  using SegmentsInDecoder = std::map<uint32_t, SegmentInDecoder>;
+  // Older segments are dropped from the map (and their missing frames are marked as dropped)
+  static constexpr size_t NR_SEGMENTS_IN_DECODER = 3;
+  uint32_t                nextSegmentTag{};
+
+  uint32_t addSegmentToDecoder(SegmentsInDecoder &segmentsInDecoder, Segment *segment);
+
+  QByteArray getAccessUnitData(const Segment &segment, unsigned accessUnitIdx) const;
+  // Access units above the temporal layer filter are skipped. Non-reference pictures are skipped
+  // if too few frames are decoded ahead of the display.
+  bool       skipAccessUnit(const Segment &segment, unsigned accessUnitIdx);
+  void       onAccessUnitPushed(Segment &segment, unsigned accessUnitIdx);
+  // Place the current frame of the decoder into its frame using the CTS of the frame. Returns the
+  // segment of the frame.
+  Segment *storeDecodedFrame(SegmentsInDecoder &   segmentsInDecoder,
+                             decoder::decoderBase &frameDecoder);
+  void     storeDecodedFrame(Segment &             segment,
+                             unsigned              accessUnitIdx,
+                             unsigned              frameIdx,
+                             decoder::decoderBase &frameDecoder);
+  void     dropAccessUnit(Segment &segment, unsigned accessUnitIdx);
+  void     dropUnfinishedFrames(const SegmentInDecoder &segmentInDecoder);
+  // Add the segment to the statistics once none of its frames is empty anymore. Frames are
+  // finished by the decoder thread, the drain thread and by dropping, but only the first caller
+  // that sees the finished segment records it.
+  void recordSegmentIfFinished(Segment &segment);
+  void     setDecoding(bool decoding);
+
+  std::unique_ptr<decoder::decoderBase> createDecoder();
+
+  // On a rendition switch, the old decoder is flushed in the drain thread. The remaining frames
+  // of the old rendition go into the given segments.
+  bool startDrainingDecoder(SegmentsInDecoder segmentsInDecoder);
+  void drainDecoder(std::unique_ptr<decoder::decoderBase> drainingDecoder,
+                    SegmentsInDecoder                     segmentsInDecoder);
+  std::thread drainThread;
+
+  decoder::DecoderSettings              decoderSettings;
+  QString                               effectiveDecoderSettings;
+  QString                               decoderInfo;
   std::unique_ptr<decoder::decoderBase> decoder;
 
+  // A flushed vvdec instance can not take a new bitstream without being closed and opened again.
+  // So on a rendition switch, the flushed decoder is replaced by an already opened spare decoder.
+  // The drain thread reopens the flushed decoder and hands it back as a spare decoder.
+  std::vector<std::unique_ptr<decoder::decoderBase>> spareDecoders;
+  std::mutex                                         spareDecodersMutex;
+
+  // Time from detecting a rendition switch to the first decoded frame of the new rendition
+  std::chrono::steady_clock::time_point switchStart;
+  Segment *                             switchTargetSegment{};
+  std::atomic<int64_t>                  lastSwitchLatencyUs{-1};
+
   std::thread decoderThread;
   bool        decoderAbort{};
   bool        adaptiveResolutioChange{};
 
+  std::atomic<unsigned>   nrTemporalLayersToSkip{};
+  std::optional<unsigned> maxTemporalIdToDecode;
+
   QByteArray highestRenditionSPS;
 
   QString statusText;
+
+  std::atomic<unsigned>                 nrFramesDecoded{};
+  std::atomic<unsigned>                 nrFramesSkipped{};
+  std::atomic<int64_t>                  decodingDurationUs{};
+  std::chrono::steady_clock::time_point decodingStart;
+  std::chrono::steady_clock::time_point waitingStart;
+  bool                                  decoding{};
+  int64_t                               lastWaitUs{};
+
+  DecoderStatistics statistics;
 };
@@ -24,9 +24,10 @@ SOFTWARE. */
 #include "FileParserThread.h"
 
 #include <common/functions.h>
-#include <parser/VVC/AnnexBVVC.h>
+#include <parser/SegmentIndex.h>
 
 #include <QDebug>
+#include <QSettings>
 #include <chrono>
 
 #define DEBUG_PARSER 0
@@ -40,7 +41,9 @@ SOFTWARE. */
 FileParserThread::FileParserThread(ILogger *logger, SegmentBuffer *segmentBuffer)
     : logger(logger), segmentBuffer(segmentBuffer)
 {
-  this->parserThread = std::thread(&FileParserThread::runParser, this);
+  this->parameterSetCache = std::make_shared<parser::vvc::ParameterSetCache>();
+  this->writeIndexFiles   = QSettings().value("WriteSegmentIndexFiles", false).toBool();
+  this->parserThread      = std::thread(&FileParserThread::runParser, this);
 }
 
 FileParserThread::~FileParserThread()
@@ -54,84 +57,92 @@ void FileParserThread::abort() { this->parserAbort = true; }
 
 QString FileParserThread::getStatus() const
 {
-  return (this->parserAbort ? "Abort " : "") + this->statusText;
+  return (this->parserAbort ? "Abort " : "") + this->statusText +
+         QString(" (Parameter set cache %1 hits %2 misses)")
+             .arg(this->parameterSetCache->getNrHits())
+             .arg(this->parameterSetCache->getNrMisses());
 }
 
 void FileParserThread::runParser()
 {
   this->logger->addMessage("Started parser thread", LoggingPriority::Info);
 
-  size_t currentDataOffset{};
-  auto   segmentIt = this->segmentBuffer->getFirstSegmentToParse();
+  auto segmentIt = this->segmentBuffer->getFirstSegmentToParse();
 
   while (!this->parserAbort)
   {
-    const auto &data = segmentIt->compressedData;
-
-    parser::AnnexBVVC parser;
+    auto parsingStart = StageStatistics::Clock::now();
+    auto index        = this->getSegmentIndex(*segmentIt);
+    if (this->parserAbort)
+      return;
 
-    int nalID = 0;
-    if (auto firstPos = findNextNalInData(data, 0))
-      currentDataOffset = *firstPos;
-    bool isLastNalInData = false;
-    while (!this->parserAbort)
+    for (const auto &accessUnit : index.accessUnits)
     {
-      QByteArray nalData;
-
-      if (!isLastNalInData)
-      {
-        if (auto nextNalStart = findNextNalInData(data, currentDataOffset + 3))
-        {
-          auto length       = *nextNalStart - currentDataOffset;
-          nalData           = data.mid(currentDataOffset, length);
-          currentDataOffset = *nextNalStart;
-        }
-        else if (currentDataOffset < size_t(data.size()))
-        {
-          nalData           = data.mid(currentDataOffset);
-          currentDataOffset = data.size();
-          isLastNalInData   = true;
-        }
-      }
-      else
-        nalID = -1;
-
-      DEBUG("Parsing NAL of " << nalData.size() << " bytes");
-      auto parseResult = parser.parseAndAddNALUnit(nalID, convertToByteVector(nalData), {});
-      if (parseResult.success)
-      {
-        if (parseResult.bitrateEntry)
-        {
-          // New AU
-          DEBUG("AU PTS:" << parseResult.bitrateEntry->pts
-                          << " bitrate:" << parseResult.bitrateEntry->bitrate);
-          auto newFrame               = segmentBuffer->addNewFrameToSegment(segmentIt);
-          newFrame->nrBytesCompressed = parseResult.bitrateEntry->bitrate;
-          newFrame->poc               = parseResult.bitrateEntry->pts;
-        }
-      }
-      else
-      {
-        this->logger->addMessage(QString("Error parsing nal %1 in Segment %2")
-                                     .arg(nalID)
-                                     .arg(segmentIt->segmentInfo.segmentNumber),
-                                 LoggingPriority::Error);
-      }
-
-      if (nalID == -1)
-        break;
-
-      nalID++;
+      DEBUG("AU POC:" << accessUnit.poc << " size:" << accessUnit.sizeBytes);
+      auto newFrame                  = segmentBuffer->addNewFrameToSegment(segmentIt);
+      newFrame->nrBytesCompressed    = accessUnit.sizeBytes;
+      newFrame->compressedDataOffset = accessUnit.offset;
+      newFrame->poc                  = accessUnit.poc;
+      newFrame->temporalId           = accessUnit.temporalId;
+      newFrame->nonReference         = accessUnit.nonReference;
     }
 
-    segmentIt->parsingFinished = true;
+    segmentIt->updateDisplayIndices();
+    segmentIt->parsingFinishedTime = std::chrono::steady_clock::now();
+    segmentIt->parsingFinished     = true;
+    this->statistics.addWork(index.accessUnits.size(),
+                             segmentIt->parsingFinishedTime - parsingStart);
 
     if (this->parserAbort)
       return;
 
     // This may block until there is another segment to parse
+    auto waitStart   = StageStatistics::Clock::now();
     this->statusText = "Waiting";
     segmentIt        = this->segmentBuffer->getNextSegmentToParse(segmentIt);
     this->statusText = "Parsing";
+    this->statistics.addWaitTime(StageStatistics::Clock::now() - waitStart);
   }
 }
+
+parser::SegmentIndex FileParserThread::getSegmentIndex(const Segment &segment)
+{
+  const auto &data = segment.compressedData;
+
+  if (segment.isLocalFile)
+  {
+    auto indexFileName = parser::getSegmentIndexFileName(segment.segmentInfo.downloadUrl);
+    if (auto index = parser::readSegmentIndexFile(indexFileName))
+    {
+      if (parser::isSegmentIndexValidForSegment(*index, data))
+      {
+        DEBUG("Using index file " << indexFileName);
+        return *index;
+      }
+      this->logger->addMessage(QString("Index file %1 does not match segment. Ignoring it.")
+                                   .arg(indexFileName),
+                               LoggingPriority::Warning);
+    }
+  }
+
+  std::vector<int> nalsWithErrors;
+  auto index = parser::buildSegmentIndex(
+      data, &nalsWithErrors, &this->parserAbort, this->parameterSetCache);
+  for (const auto nalID : nalsWithErrors)
+    this->logger->addMessage(QString("Error parsing nal %1 in Segment %2")
+                                 .arg(nalID)
+                                 .arg(segment.segmentInfo.segmentNumber),
+                             LoggingPriority::Error);
+
+  // Optionally write the index so that the next playback of the local file does not have to parse
+  // it. This is off by default because it writes files next to the media.
+  if (this->writeIndexFiles && segment.isLocalFile && nalsWithErrors.empty() &&
+      !this->parserAbort)
+  {
+    auto indexFileName = parser::getSegmentIndexFileName(segment.segmentInfo.downloadUrl);
+    if (!parser::writeSegmentIndexFile(indexFileName, index))
+      DEBUG("Unable to write index file " << indexFileName);
+  }
+
+  return index;
+}
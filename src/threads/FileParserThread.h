@@ -23,9 +23,12 @@ SOFTWARE. */
 
 #pragma once
 
+#include "StageStatistics.h"
+
 #include <SegmentBuffer.h>
 #include <common/ILogger.h>
 #include <decoder/decoderBase.h>
+#include <parser/SegmentIndex.h>
 
 #include <condition_variable>
 #include <optional>
@@ -40,16 +43,26 @@ public:
 
   QString getStatus() const;
 
+  StageStatistics::Snapshot getStatistics() const { return this->statistics.getSnapshot(); }
+
 private:
   ILogger *      logger{};
   SegmentBuffer *segmentBuffer{};
 
   void runParser();
 
+  // Read the index from the sidecar file (local files only) or parse the segment to build it
+  parser::SegmentIndex getSegmentIndex(const Segment &segment);
+  bool                 writeIndexFiles{false};
+
   std::unique_ptr<decoder::decoderBase> decoder;
 
+  // Shared by the parsers of all segments
+  std::shared_ptr<parser::vvc::ParameterSetCache> parameterSetCache;
+
   std::thread parserThread;
   bool        parserAbort{false};
 
-  QString statusText;
+  QString         statusText;
+  StageStatistics statistics;
 };
@@ -24,6 +24,8 @@ SOFTWARE. */
 #include "FrameConversionThread.h"
 #include <video/YUVConversion.h>
 
+#include <algorithm>
+
 #define DEBUG_CONVERSION 0
 #if DEBUG_CONVERSION
 #include <QDebug>
@@ -32,6 +34,26 @@ SOFTWARE. */
 #define DEBUG(f) ((void)0)
 #endif
 
+namespace
+{
+
+Size getOutputSize(const Size &frameSize, const Size &targetSize)
+{
+  if (!targetSize.isValid() || !frameSize.isValid())
+    return frameSize;
+  if (frameSize.width <= targetSize.width && frameSize.height <= targetSize.height)
+    return frameSize;
+
+  // Keep the aspect ratio. The full width or the full height of the target is used.
+  if (uint64_t(targetSize.width) * frameSize.height > uint64_t(targetSize.height) * frameSize.width)
+    return Size(std::max(frameSize.width * targetSize.height / frameSize.height, 1u),
+                targetSize.height);
+  return Size(targetSize.width,
+              std::max(frameSize.height * targetSize.width / frameSize.width, 1u));
+}
+
+} // namespace
+
 FrameConversionThread::FrameConversionThread(ILogger *logger, SegmentBuffer *segmentBuffer)
     : logger(logger), segmentBuffer(segmentBuffer)
 {
@@ -49,7 +71,21 @@ void FrameConversionThread::abort() { this->conversionAbort = true; }
 
 QString FrameConversionThread::getStatus() const
 {
-  return (this->conversionAbort ? "Abort " : "") + this->statusText;
+  auto status = (this->conversionAbort ? "Abort " : "") + this->statusText;
+  if (!this->convertToRGB)
+    status += " (YUV rendered directly)";
+  return status;
+}
+
+void FrameConversionThread::setConvertToRGB(bool convertToRGB)
+{
+  this->convertToRGB = convertToRGB;
+}
+
+void FrameConversionThread::setTargetSize(Size targetSize)
+{
+  std::scoped_lock lock(this->targetSizeMutex);
+  this->targetSize = targetSize;
 }
 
 void FrameConversionThread::runConversion()
@@ -59,11 +95,24 @@ void FrameConversionThread::runConversion()
   while (!this->conversionAbort)
   {
     DEBUG("Conversion Thread: Convert Frame " << frameCounter);
-    convertYUVToImage(frameIt.frame->rawYUVData,
-                      frameIt.frame->rgbImage,
-                      frameIt.frame->pixelFormat,
-                      frameIt.frame->frameSize);
-    frameIt.frame->frameState = FrameState::ConvertedToRGB;
+    auto conversionStart = StageStatistics::Clock::now();
+    if (frameIt.frame->dropped || !this->convertToRGB)
+      frameIt.frame->rgbImage = QImage();
+    else
+    {
+      Size targetSize;
+      {
+        std::scoped_lock lock(this->targetSizeMutex);
+        targetSize = this->targetSize;
+      }
+      convertYUVToImage(frameIt.frame->rawYUVData,
+                        frameIt.frame->rgbImage,
+                        frameIt.frame->pixelFormat,
+                        frameIt.frame->frameSize,
+                        getOutputSize(frameIt.frame->frameSize, targetSize));
+    }
+    this->segmentBuffer->onFrameConverted(*frameIt.frame);
+    this->statistics.addWork(1, StageStatistics::Clock::now() - conversionStart);
     this->conversionRunning.store(false);
     DEBUG("Conversion Thread: Frame " << frameCounter << " done.");
     frameCounter++;
@@ -73,10 +122,12 @@ void FrameConversionThread::runConversion()
 
     // This may block until a frame is available
     this->conversionRunning.store(false);
+    auto waitStart   = StageStatistics::Clock::now();
     this->statusText = "Paused";
     frameIt          = this->segmentBuffer->getNextFrameToConvert(frameIt);
     this->conversionRunning.store(true);
     this->statusText = "Running";
+    this->statistics.addWaitTime(StageStatistics::Clock::now() - waitStart);
   }
 
   statusText = "Thread stopped";
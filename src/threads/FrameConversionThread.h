@@ -23,6 +23,8 @@ SOFTWARE. */
 
 #pragma once
 
+#include "StageStatistics.h"
+
 #include <SegmentBuffer.h>
 #include <common/Frame.h>
 #include <common/ILogger.h>
@@ -30,6 +32,7 @@ SOFTWARE. */
 #include <QByteArray>
 #include <QImage>
 #include <condition_variable>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <thread>
@@ -43,6 +46,16 @@ public:
 
   QString getStatus() const;
 
+  StageStatistics::Snapshot getStatistics() const { return this->statistics.getSnapshot(); }
+
+  // If the YUV data is rendered directly (with OpenGL), the frames are only passed on to the
+  // display without converting them to RGB.
+  void setConvertToRGB(bool convertToRGB);
+
+  // Frames that are larger than this size are converted directly to the largest size with the
+  // same aspect ratio that fits into it. An invalid size converts in full resolution.
+  void setTargetSize(Size targetSize);
+
 private:
   ILogger *      logger{};
   SegmentBuffer *segmentBuffer{};
@@ -55,6 +68,11 @@ private:
   std::condition_variable bufferFullCV;
 
   std::atomic_bool conversionRunning{false};
+  std::atomic_bool convertToRGB{true};
+
+  std::mutex targetSizeMutex;
+  Size       targetSize{};
 
-  QString statusText;
+  QString         statusText;
+  StageStatistics statistics;
 };
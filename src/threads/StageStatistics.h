@@ -0,0 +1,78 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/* Throughput counters of a pipeline stage that handles frames (the parser or the conversion).
+ *
+ * The thread of the stage adds the time it was working and the time it was blocked waiting for
+ * input. The counters can be read from any thread.
+ */
+class StageStatistics
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  void addWork(uint64_t nrFrames, Clock::duration workTime)
+  {
+    this->nrFrames += nrFrames;
+    this->workUs += std::chrono::duration_cast<std::chrono::microseconds>(workTime).count();
+  }
+  void addWaitTime(Clock::duration waitTime)
+  {
+    this->waitUs += std::chrono::duration_cast<std::chrono::microseconds>(waitTime).count();
+  }
+
+  struct Snapshot
+  {
+    uint64_t nrFrames{};
+    int64_t  workUs{};
+    int64_t  waitUs{};
+
+    // The frames per second the stage could process if it never had to wait
+    double getFPS() const
+    {
+      if (this->workUs == 0)
+        return 0.0;
+      return double(this->nrFrames) * 1000000.0 / double(this->workUs);
+    }
+  };
+
+  Snapshot getSnapshot() const
+  {
+    Snapshot snapshot;
+    snapshot.nrFrames = this->nrFrames.load();
+    snapshot.workUs   = this->workUs.load();
+    snapshot.waitUs   = this->waitUs.load();
+    return snapshot;
+  }
+
+private:
+  std::atomic<uint64_t> nrFrames{0};
+  std::atomic<int64_t>  workUs{0};
+  std::atomic<int64_t>  waitUs{0};
+};
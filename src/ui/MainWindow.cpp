@@ -26,6 +26,7 @@ SOFTWARE. */
 #include <common/Typedef.h>
 #include <decoder/decoderVVDec.h>
 
+#include <QFile>
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QKeyEvent>
@@ -34,14 +35,17 @@ SOFTWARE. */
 constexpr auto DEFAULT_SEGMENT_PATTERN = "segment-%i.vvc";
 constexpr auto SINTEL_SEGMENT_NR       = 887;
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
+MainWindow::MainWindow(decoder::DecoderSettings decoderSettings, QWidget *parent)
+    : QMainWindow(parent)
 {
   this->ui.setupUi(this);
   this->setFocusPolicy(Qt::StrongFocus);
   this->createMenusAndActions();
 
-  this->playbackController = std::make_unique<PlaybackController>(this->ui.viewWidget);
+  this->playbackController =
+      std::make_unique<PlaybackController>(this->ui.viewWidget, decoderSettings);
   this->ui.viewWidget->setPlaybackController(this->playbackController.get());
+  this->ui.viewWidget->setRenderYUVWithOpenGL(this->actionRenderWithOpenGL.isChecked());
 }
 
 void MainWindow::keyPressEvent(QKeyEvent *event)
@@ -120,6 +124,13 @@ void MainWindow::toggleShowProgressGraph(bool checked)
   this->ui.viewWidget->setShowProgressGraph(checked);
 }
 
+void MainWindow::toggleRenderWithOpenGL(bool checked)
+{
+  QSettings settings;
+  settings.setValue("RenderYUVWithOpenGL", checked);
+  this->ui.viewWidget->setRenderYUVWithOpenGL(checked);
+}
+
 void MainWindow::createMenusAndActions()
 {
   QMenu *fileMenu = menuBar()->addMenu(tr("&File"));
@@ -137,6 +148,8 @@ void MainWindow::createMenusAndActions()
     presetURLs->addAction(this->fixedURLActions[i]);
   }
 
+  fileMenu->addSeparator();
+  fileMenu->addAction("Export decoder statistics ...", this, &MainWindow::exportDecoderStatistics);
   fileMenu->addSeparator();
   fileMenu->addAction("Exit", this, &MainWindow::close);
 
@@ -198,6 +211,12 @@ void MainWindow::createMenusAndActions()
                            false,
                            &MainWindow::toggleShowProgressGraph,
                            Qt::CTRL | Qt::Key_P);
+  configureCheckableAction(this->actionRenderWithOpenGL,
+                           nullptr,
+                           viewMenu,
+                           "Render YUV with &OpenGL",
+                           QSettings().value("RenderYUVWithOpenGL", true).toBool(),
+                           &MainWindow::toggleRenderWithOpenGL);
 
   auto playbackMenu = this->ui.menuBar->addMenu("Playback");
   this->addAction(playbackMenu->addAction(
@@ -206,6 +225,11 @@ void MainWindow::createMenusAndActions()
       "Increase rendition", this, &MainWindow::onIncreaseRendition, Qt::Key_Up));
   this->addAction(playbackMenu->addAction(
       "Decrease rendition", this, &MainWindow::onDecreaseRendition, Qt::Key_Down));
+  playbackMenu->addSeparator();
+  this->addAction(playbackMenu->addAction(
+      "Increase playback speed", this, &MainWindow::onIncreasePlaybackSpeed, Qt::Key_Plus));
+  this->addAction(playbackMenu->addAction(
+      "Decrease playback speed", this, &MainWindow::onDecreasePlaybackSpeed, Qt::Key_Minus));
 
   auto settingsMenu = this->ui.menuBar->addMenu("Settings");
   settingsMenu->addAction("Select VVdeC library ...", this, &MainWindow::onSelectVVDeCLibrary);
@@ -232,6 +256,27 @@ void MainWindow::openJsonManifestFile()
   }
 }
 
+void MainWindow::exportDecoderStatistics()
+{
+  auto fileName = QFileDialog::getSaveFileName(this,
+                                               "Export decoder statistics",
+                                               QDir::currentPath(),
+                                               "CSV files (*.csv);;JSON files (*.json)");
+  if (fileName.isEmpty())
+    return;
+
+  auto statistics = this->playbackController->getDecoderStatistics();
+  auto content    = fileName.toLower().endsWith(".json")
+                        ? DecoderStatistics::toJSON(statistics)
+                        : DecoderStatistics::toCSV(statistics);
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) || file.write(content.toUtf8()) < 0)
+    QMessageBox::critical(this,
+                          "Error exporting decoder statistics",
+                          "The file could not be written: " + file.errorString());
+}
+
 void MainWindow::onSelectVVDeCLibrary()
 {
   QFileDialog fileDialog(this, "Select VVDeC decoder library");
@@ -297,3 +342,15 @@ void MainWindow::onGotoSegmentNumber()
 void MainWindow::onIncreaseRendition() { this->playbackController->increaseRendition(); }
 
 void MainWindow::onDecreaseRendition() { this->playbackController->decreaseRendition(); }
+
+void MainWindow::onIncreasePlaybackSpeed()
+{
+  this->playbackController->setTrickPlaySpeed(this->playbackController->getTrickPlaySpeed() * 2);
+  this->ui.viewWidget->setPlaybackSpeed(this->playbackController->getTrickPlaySpeed());
+}
+
+void MainWindow::onDecreasePlaybackSpeed()
+{
+  this->playbackController->setTrickPlaySpeed(this->playbackController->getTrickPlaySpeed() / 2);
+  this->ui.viewWidget->setPlaybackSpeed(this->playbackController->getTrickPlaySpeed());
+}
@@ -42,7 +42,7 @@ class MainWindow : public QMainWindow
   Q_OBJECT
 
 public:
-  explicit MainWindow(QWidget *parent = 0);
+  explicit MainWindow(decoder::DecoderSettings decoderSettings = {}, QWidget *parent = 0);
 
 protected:
   virtual void mouseDoubleClickEvent(QMouseEvent *event) override
@@ -54,14 +54,18 @@ protected:
 private slots:
 
   void openJsonManifestFile();
+  void exportDecoderStatistics();
   void toggleFullscreen(bool checked);
   void toggleScaleVideo(bool checked);
   void toggleShowDebug(bool checked);
   void toggleShowProgressGraph(bool checked);
+  void toggleRenderWithOpenGL(bool checked);
   void onSelectVVDeCLibrary();
   void onGotoSegmentNumber();
   void onIncreaseRendition();
   void onDecreaseRendition();
+  void onIncreasePlaybackSpeed();
+  void onDecreasePlaybackSpeed();
   void openFixedUrl();
 
 private:
@@ -75,6 +79,7 @@ private:
   QAction                      actionScaleVideo;
   QAction                      actionShowThreadStatus;
   QAction                      actionShowProgressGraph;
+  QAction                      actionRenderWithOpenGL;
   QScopedPointer<QActionGroup> actionGroup;
 
   QPointer<QAction> fixedURLActions[2];
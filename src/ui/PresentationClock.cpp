@@ -0,0 +1,101 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "PresentationClock.h"
+
+#include <algorithm>
+#include <cmath>
+
+void PresentationClock::setFramesPerSecond(double framesPerSecond, TimePoint now)
+{
+  this->reanchor(now);
+  this->framesPerSecond = framesPerSecond;
+}
+
+void PresentationClock::pause(TimePoint now)
+{
+  if (!this->pausedAt)
+    this->pausedAt = now;
+}
+
+void PresentationClock::resume(TimePoint now)
+{
+  this->pausedAt.reset();
+  this->reanchor(now);
+}
+
+uint64_t PresentationClock::getNrFramesDue(TimePoint now) const
+{
+  if (this->pausedAt || this->framesPerSecond <= 0.0 || now < this->anchorTime)
+    return this->nrFramesTaken;
+
+  auto secondsSinceAnchor = std::chrono::duration<double>(now - this->anchorTime).count();
+  return this->anchorFrame + uint64_t(std::floor(secondsSinceAnchor * this->framesPerSecond)) + 1;
+}
+
+void PresentationClock::onFramePresented(uint64_t frameIndex, TimePoint now)
+{
+  this->waitingForFrame = false;
+
+  auto dueTime     = this->getDueTime(frameIndex);
+  auto deviationMs = std::chrono::duration<double, std::milli>(now - dueTime).count();
+  deviationMs      = std::abs(deviationMs);
+
+  this->metrics.nrFramesPresented++;
+  this->sumDeviationMs += deviationMs;
+  this->metrics.maxDeviationMs = std::max(this->metrics.maxDeviationMs, deviationMs);
+}
+
+void PresentationClock::onFrameUnavailable(TimePoint now)
+{
+  // Only count once per frame that is missing
+  if (!this->waitingForFrame)
+    this->metrics.nrFramesRepeated++;
+  this->waitingForFrame = true;
+  this->reanchor(now);
+}
+
+PresentationClock::Metrics PresentationClock::getMetrics() const
+{
+  auto metrics = this->metrics;
+  if (metrics.nrFramesPresented > 0)
+    metrics.averageDeviationMs = this->sumDeviationMs / double(metrics.nrFramesPresented);
+  return metrics;
+}
+
+void PresentationClock::reanchor(TimePoint now)
+{
+  // The next frame is due now
+  this->anchorFrame = this->nrFramesTaken;
+  this->anchorTime  = now;
+}
+
+PresentationClock::TimePoint PresentationClock::getDueTime(uint64_t frameIndex) const
+{
+  if (this->framesPerSecond <= 0.0 || frameIndex < this->anchorFrame)
+    return this->anchorTime;
+
+  auto seconds = double(frameIndex - this->anchorFrame) / this->framesPerSecond;
+  return this->anchorTime +
+         std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
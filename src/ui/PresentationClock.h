@@ -0,0 +1,91 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+/* The media clock for the presentation of frames.
+ *
+ * Frame n is due at a fixed point in time that is computed from a monotonic clock and the frame
+ * rate. On every display refresh the view takes all frames that are due by then. So the playback
+ * speed does not depend on the resolution of a timer interval and does not drift.
+ *
+ * The clock also measures how late frames are presented relative to their due time, how many
+ * frames were never shown because a later frame was already due (dropped) and how often no frame
+ * was available when one was due (repeated).
+ */
+class PresentationClock
+{
+public:
+  using Clock     = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+
+  // The due times continue from the current frame with the new rate
+  void setFramesPerSecond(double framesPerSecond, TimePoint now);
+  void pause(TimePoint now);
+  void resume(TimePoint now);
+
+  // The number of frames that should have been taken for display by now
+  uint64_t getNrFramesDue(TimePoint now) const;
+  uint64_t getNrFramesTaken() const { return this->nrFramesTaken; }
+
+  // Every frame taken from the buffer (also when paused and stepping through frames)
+  void onFrameTaken() { this->nrFramesTaken++; }
+  // The frame with the given index (counted in taken frames) is shown now
+  void onFramePresented(uint64_t frameIndex, TimePoint now);
+  // A taken frame was replaced by a later one before it was shown
+  void onFrameDropped() { this->metrics.nrFramesDropped++; }
+  // A frame is due but there is none available. The clock waits for the frame so that playback
+  // continues from it instead of rushing through the frames that are late.
+  void onFrameUnavailable(TimePoint now);
+
+  struct Metrics
+  {
+    uint64_t nrFramesPresented{};
+    uint64_t nrFramesDropped{};
+    uint64_t nrFramesRepeated{};
+    double   averageDeviationMs{};
+    double   maxDeviationMs{};
+  };
+  Metrics getMetrics() const;
+
+private:
+  void      reanchor(TimePoint now);
+  TimePoint getDueTime(uint64_t frameIndex) const;
+
+  double framesPerSecond{};
+
+  // The frame with the index anchorFrame is due at anchorTime
+  uint64_t  anchorFrame{};
+  TimePoint anchorTime{};
+
+  uint64_t                 nrFramesTaken{};
+  std::optional<TimePoint> pausedAt;
+  bool                     waitingForFrame{};
+
+  Metrics metrics;
+  double  sumDeviationMs{};
+};
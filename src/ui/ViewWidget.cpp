@@ -23,10 +23,12 @@ SOFTWARE. */
 
 #include "ViewWidget.h"
 
+#include <video/YUVConversion.h>
+
 #include <QPainter>
-#include <QPalette>
 #include <QRectF>
 #include <QTimerEvent>
+#include <algorithm>
 #include <assert.h>
 
 #define DEBUG_WIDGET 0
@@ -41,22 +43,55 @@ namespace
 {
 
 constexpr auto    INFO_MESSAGE_TIMEOUT        = std::chrono::seconds(10);
+constexpr auto    OVERLAY_UPDATE_INTERVAL     = std::chrono::milliseconds(100);
+constexpr auto    PAINT_TIME_NR_PAINTS        = 50u;
+constexpr auto    PROGRESS_GRAPH_HEIGHT       = 300;
 static const auto SEMGENT_LENGTH_FRAMES_GUESS = 24u;
 
 } // namespace
 
-ViewWidget::ViewWidget(QWidget *parent) : QWidget(parent)
+ViewWidget::ViewWidget(QWidget *parent) : QOpenGLWidget(parent)
 {
-  auto pal = this->palette();
-  pal.setColor(QPalette::Window, Qt::black);
-  this->setAutoFillBackground(true);
-  this->setPalette(pal);
+  connect(this, &QOpenGLWidget::frameSwapped, this, &ViewWidget::onFrameSwapped);
+  this->timer.start(int(OVERLAY_UPDATE_INTERVAL.count()), this);
+}
+
+ViewWidget::~ViewWidget()
+{
+  this->makeCurrent();
+  this->yuvRenderer.cleanup();
+  this->doneCurrent();
 }
 
 void ViewWidget::setPlaybackController(PlaybackController *playbackController)
 {
   assert(playbackController != nullptr);
   this->playbackController = playbackController;
+  this->playbackController->setConvertFramesToRGB(!this->renderYUVWithOpenGL);
+  this->updateConversionTargetSize();
+}
+
+void ViewWidget::setRenderYUVWithOpenGL(bool renderWithOpenGL)
+{
+  this->renderYUVWithOpenGL = renderWithOpenGL && !this->openGLFailed;
+  if (this->playbackController)
+    this->playbackController->setConvertFramesToRGB(!this->renderYUVWithOpenGL);
+  this->updateConversionTargetSize();
+  this->update();
+}
+
+void ViewWidget::updateConversionTargetSize()
+{
+  if (!this->playbackController)
+    return;
+
+  Size targetSize;
+  if (this->scaleVideo && !this->renderYUVWithOpenGL)
+  {
+    auto pixelRatio = this->devicePixelRatioF();
+    targetSize      = Size(int(this->width() * pixelRatio), int(this->height() * pixelRatio));
+  }
+  this->playbackController->setConversionTargetSize(targetSize);
 }
 
 void ViewWidget::addMessage(QString message, LoggingPriority priority)
@@ -68,36 +103,101 @@ void ViewWidget::addMessage(QString message, LoggingPriority priority)
   msg.priority  = priority;
   msg.timeAdded = std::chrono::steady_clock::now();
   this->messages.push_back(msg);
+  this->messagesLayer.valid = false;
+  this->messagesChanged     = true;
+}
+
+void ViewWidget::initializeGL()
+{
+  if (this->yuvRenderer.initialize(this))
+    return;
+
+  this->addMessage("OpenGL rendering not available. Using the software conversion.",
+                   LoggingPriority::Warning);
+  this->openGLFailed = true;
+  this->setRenderYUVWithOpenGL(false);
+}
+
+void ViewWidget::resizeGL(int, int)
+{
+  // The device pixel ratio may have changed as well
+  this->invalidateOverlays();
+  this->updateConversionTargetSize();
 }
 
-void ViewWidget::paintEvent(QPaintEvent *)
+void ViewWidget::paintGL()
 {
+  auto paintStart = std::chrono::steady_clock::now();
+
   QPainter painter(this);
   painter.setRenderHint(QPainter::RenderHint::SmoothPixmapTransform);
+  painter.fillRect(this->rect(), Qt::black);
 
   DEBUG("Paint event");
 
   this->drawCurrentFrame(painter);
-  this->drawAndUpdateMessages(painter);
+
+  auto overlaysStart = std::chrono::steady_clock::now();
+  this->drawMessages(painter);
   this->drawFPSAndStatusText(painter);
   this->drawRenditionInfo(painter);
   this->drawProgressGraph(painter);
+  auto paintEnd = std::chrono::steady_clock::now();
+
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  this->updatePaintTime(Milliseconds(paintEnd - paintStart).count(),
+                        Milliseconds(paintEnd - overlaysStart).count());
+  this->lastPaint = PresentationClock::Clock::now();
 }
 
-void ViewWidget::drawCurrentFrame(QPainter &painter)
+void ViewWidget::updatePaintTime(double paintMs, double overlaysMs)
 {
-  if (this->curFrame.isNull())
-    return;
+  auto &paintTime = this->paintTime;
+  paintTime.nrPaints++;
+  paintTime.sumMs += paintMs;
+  paintTime.sumOverlaysMs += overlaysMs;
+  paintTime.curMaxMs = std::max(paintTime.curMaxMs, paintMs);
 
-  auto &rgbImage = this->curFrame.frame->rgbImage;
-  if (rgbImage.isNull())
+  if (paintTime.nrPaints < PAINT_TIME_NR_PAINTS)
     return;
 
+  paintTime.averageMs         = paintTime.sumMs / paintTime.nrPaints;
+  paintTime.overlaysAverageMs = paintTime.sumOverlaysMs / paintTime.nrPaints;
+  paintTime.maxMs             = paintTime.curMaxMs;
+  paintTime.nrPaints          = 0;
+  paintTime.sumMs             = 0.0;
+  paintTime.sumOverlaysMs     = 0.0;
+  paintTime.curMaxMs          = 0.0;
+}
+
+QPixmap ViewWidget::createLayerPixmap(QSize size) const
+{
+  // Render in device pixels so that the text stays sharp on high DPI screens
+  auto    pixelRatio = this->devicePixelRatioF();
+  QPixmap pixmap(int(size.width() * pixelRatio), int(size.height() * pixelRatio));
+  pixmap.setDevicePixelRatio(pixelRatio);
+  pixmap.fill(Qt::transparent);
+  return pixmap;
+}
+
+void ViewWidget::invalidateOverlays()
+{
+  {
+    std::scoped_lock lock(this->messagesMutex);
+    this->messagesLayer.valid = false;
+  }
+  this->statusTextLayer.valid    = false;
+  this->renditionInfoLayer.valid = false;
+  this->progressGraphLayer.valid = false;
+}
+
+QRect ViewWidget::getVideoRect(QSize frameSize) const
+{
+  QRect drawRect;
   if (this->scaleVideo)
   {
-    QRect drawRect;
-    auto  aspectRatioImage  = double(rgbImage.width()) / double(rgbImage.height());
-    auto  aspectRatioWidget = double(this->width()) / double(this->height());
+    auto aspectRatioImage  = double(frameSize.width()) / double(frameSize.height());
+    auto aspectRatioWidget = double(this->width()) / double(this->height());
     if (aspectRatioWidget > aspectRatioImage)
     {
       // Full height, black bars left and right
@@ -112,77 +212,162 @@ void ViewWidget::drawCurrentFrame(QPainter &painter)
       drawRect.setWidth(this->width());
       drawRect.moveTopLeft(QPoint(0, (this->height() - drawRect.height()) / 2));
     }
-    painter.drawImage(drawRect, rgbImage);
   }
   else
   {
-    int x = (this->width() - rgbImage.width()) / 2;
-    int y = (this->height() - rgbImage.height()) / 2;
-    painter.drawImage(x, y, rgbImage);
+    drawRect.setSize(frameSize);
+    drawRect.moveTopLeft(QPoint((this->width() - frameSize.width()) / 2,
+                                (this->height() - frameSize.height()) / 2));
+  }
+  return drawRect;
+}
+
+void ViewWidget::drawCurrentFrame(QPainter &painter)
+{
+  if (!this->curImage.isNull())
+  {
+    painter.drawImage(this->getVideoRect(this->curImage.size()), this->curImage);
+    return;
   }
+
+  if (!this->renderYUVWithOpenGL || !this->yuvRenderer.hasFrame())
+    return;
+
+  auto frameSize = this->yuvRenderer.getFrameSize();
+  auto videoRect = this->getVideoRect(QSize(int(frameSize.width), int(frameSize.height)));
+
+  // The renderer works in device pixels
+  auto pixelRatio = this->devicePixelRatioF();
+  auto deviceRect = QRect(int(videoRect.x() * pixelRatio),
+                          int(videoRect.y() * pixelRatio),
+                          int(videoRect.width() * pixelRatio),
+                          int(videoRect.height() * pixelRatio));
+  auto viewportSize = QSize(int(this->width() * pixelRatio), int(this->height() * pixelRatio));
+
+  painter.beginNativePainting();
+  this->yuvRenderer.draw(deviceRect, viewportSize);
+  painter.endNativePainting();
+}
+
+void ViewWidget::removeExpiredMessages()
+{
+  std::scoped_lock lock(this->messagesMutex);
+
+  auto now = std::chrono::steady_clock::now();
+  auto it  = std::remove_if(this->messages.begin(), this->messages.end(), [&now](auto &message) {
+    return message.priority == LoggingPriority::Info &&
+           now - message.timeAdded > INFO_MESSAGE_TIMEOUT;
+  });
+  if (it == this->messages.end())
+    return;
+
+  this->messages.erase(it, this->messages.end());
+  this->messagesLayer.valid = false;
+  this->messagesChanged     = true;
 }
 
-void ViewWidget::drawAndUpdateMessages(QPainter &painter)
+void ViewWidget::drawMessages(QPainter &painter)
 {
-  unsigned           yOffset = 0;
-  constexpr unsigned MARGIN  = 2;
+  constexpr int MARGIN = 2;
+
+  static const auto colorMap =
+      std::map<LoggingPriority, QColor>({{LoggingPriority::Info, Qt::cyan},
+                                         {LoggingPriority::Warning, Qt::darkYellow},
+                                         {LoggingPriority::Error, Qt::darkRed}});
 
   std::scoped_lock lock(this->messagesMutex);
 
-  auto it = this->messages.begin();
-  while (it != this->messages.end())
+  if (this->messages.empty())
+    return;
+
+  if (!this->messagesLayer.valid)
   {
-    auto age = std::chrono::steady_clock::now() - it->timeAdded;
-    if (it->priority == LoggingPriority::Info && age > INFO_MESSAGE_TIMEOUT)
+    QFontMetrics       fontMetrics(painter.font());
+    std::vector<QRect> boxRects;
+    int                layerWidth  = 0;
+    int                layerHeight = 0;
+    for (const auto &message : this->messages)
     {
-      it = this->messages.erase(it);
-      continue;
+      auto textSize = fontMetrics.size(0, message.message);
+      auto boxRect =
+          QRect(0, layerHeight, textSize.width() + 2 * MARGIN, textSize.height() + 2 * MARGIN);
+      boxRects.push_back(boxRect);
+      layerWidth = std::max(layerWidth, boxRect.width());
+      layerHeight += boxRect.height();
     }
 
-    auto text     = it->message;
-    auto textSize = QFontMetrics(painter.font()).size(0, text);
-
-    QRect textRect;
-    textRect.setSize(textSize);
-    textRect.moveTopLeft(QPoint(MARGIN, yOffset + MARGIN));
+    auto     pixmap = this->createLayerPixmap(QSize(layerWidth, layerHeight));
+    QPainter layerPainter(&pixmap);
+    layerPainter.setFont(painter.font());
+    for (size_t i = 0; i < this->messages.size(); i++)
+    {
+      const auto &message = this->messages.at(i);
+      const auto &boxRect = boxRects.at(i);
 
-    // Draw the colored background box
-    auto       boxRect = textRect + QMargins(MARGIN, MARGIN, MARGIN, MARGIN);
-    const auto colorMap =
-        std::map<LoggingPriority, QColor>({{LoggingPriority::Info, Qt::cyan},
-                                           {LoggingPriority::Warning, Qt::darkYellow},
-                                           {LoggingPriority::Error, Qt::darkRed}});
-    painter.setBrush(colorMap.at(it->priority));
-    painter.drawRect(boxRect);
+      // Draw the colored background box
+      layerPainter.setBrush(colorMap.at(message.priority));
+      layerPainter.drawRect(boxRect);
 
-    painter.drawText(textRect, Qt::AlignRight, text);
+      auto textRect = boxRect.adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN);
+      layerPainter.drawText(textRect, Qt::AlignRight, message.message);
+    }
+    layerPainter.end();
 
-    yOffset += boxRect.height();
-    it++;
+    this->messagesLayer.pixmap = pixmap;
+    this->messagesLayer.size   = QSize(layerWidth, layerHeight);
+    this->messagesLayer.valid  = true;
   }
+
+  painter.drawPixmap(QPoint(0, 0), this->messagesLayer.pixmap);
 }
 
 void ViewWidget::drawFPSAndStatusText(QPainter &painter)
 {
   auto text = QString("FPS: %1\n").arg(this->actualFPS);
+  if (this->playbackSpeed > 1)
+    text = QString("FPS: %1 (%2x)\n").arg(this->actualFPS).arg(this->playbackSpeed);
   if (this->playbackController && this->showDebugInfo)
+  {
+    auto metrics = this->presentationClock.getMetrics();
+    text += QString("Presentation: deviation avg %1 ms max %2 ms dropped %3 repeated %4\n")
+                .arg(metrics.averageDeviationMs, 0, 'f', 1)
+                .arg(metrics.maxDeviationMs, 0, 'f', 1)
+                .arg(metrics.nrFramesDropped)
+                .arg(metrics.nrFramesRepeated);
+    text += QString("Paint: avg %1 ms max %2 ms (overlays %3 ms)\n")
+                .arg(this->paintTime.averageMs, 0, 'f', 2)
+                .arg(this->paintTime.maxMs, 0, 'f', 2)
+                .arg(this->paintTime.overlaysAverageMs, 0, 'f', 2);
     text += this->playbackController->getStatus();
-  auto textSize = QFontMetrics(painter.font()).size(0, text);
+  }
 
-  if (this->showDebugInfo)
+  if (this->statusTextLayer.needsUpdate(text))
   {
-    if (textSize.width() > this->debugInfoRenderMaxWidth)
-      this->debugInfoRenderMaxWidth = textSize.width();
-    else
-      textSize.setWidth(this->debugInfoRenderMaxWidth);
-  }
+    auto textSize = QFontMetrics(painter.font()).size(0, text);
 
-  QRect textRect;
-  textRect.setSize(textSize);
-  textRect.moveTopRight(QPoint(this->width(), 0));
+    if (this->showDebugInfo)
+    {
+      if (textSize.width() > this->debugInfoRenderMaxWidth)
+        this->debugInfoRenderMaxWidth = textSize.width();
+      else
+        textSize.setWidth(this->debugInfoRenderMaxWidth);
+    }
+
+    auto     pixmap = this->createLayerPixmap(textSize);
+    QPainter layerPainter(&pixmap);
+    layerPainter.setFont(painter.font());
+    layerPainter.setPen(Qt::white);
+    layerPainter.drawText(QRect(QPoint(0, 0), textSize), Qt::AlignLeft, text);
+    layerPainter.end();
+
+    this->statusTextLayer.pixmap = pixmap;
+    this->statusTextLayer.size   = textSize;
+    this->statusTextLayer.key    = text;
+    this->statusTextLayer.valid  = true;
+  }
 
-  painter.setPen(Qt::white);
-  painter.drawText(textRect, Qt::AlignLeft, text);
+  auto layerWidth = this->statusTextLayer.size.width();
+  painter.drawPixmap(QPoint(this->width() - layerWidth, 0), this->statusTextLayer.pixmap);
 }
 
 void ViewWidget::drawRenditionInfo(QPainter &painter)
@@ -191,45 +376,78 @@ void ViewWidget::drawRenditionInfo(QPainter &painter)
   if (manifest == nullptr || this->curFrame.isNull())
     return;
 
-  auto renditions               = manifest->getRenditionInfos();
   auto currentTargetRendition   = int(manifest->getCurrentRencodition());
   auto currentPlaybackRendition = int(this->curFrame.segment->segmentInfo.rendition);
 
-  const auto arrawText     = "-->";
-  const auto arrowTextSize = QFontMetrics(painter.font()).size(0, arrawText);
-  QRect      arrowTextRect;
-  arrowTextRect.setSize(arrowTextSize);
-  arrowTextRect.setLeft(0);
-
-  unsigned topPos = 0;
-  for (auto i = int(renditions.size()) - 1; i >= 0; --i)
+  // The renditions of a manifest do not change
+  auto key = QString("%1 %2 %3")
+                 .arg(quintptr(manifest))
+                 .arg(currentTargetRendition)
+                 .arg(currentPlaybackRendition);
+  if (this->renditionInfoLayer.needsUpdate(key))
   {
-    const auto &rendition = renditions.at(i);
+    auto renditions = manifest->getRenditionInfos();
+
+    QFontMetrics fontMetrics(painter.font());
+    const auto   arrawText     = "-->";
+    const auto   arrowTextSize = fontMetrics.size(0, arrawText);
 
-    painter.setPen(i == currentPlaybackRendition ? Qt::green : Qt::white);
-    if (i == currentTargetRendition)
+    std::vector<QString> texts;
+    int                  layerWidth  = 0;
+    int                  layerHeight = 0;
+    for (const auto &rendition : renditions)
     {
-      arrowTextRect.moveTop(topPos);
-      painter.drawText(arrowTextRect, Qt::AlignLeft, arrawText);
+      auto text = QString("%1 - %2x%3@%4")
+                      .arg(rendition.name)
+                      .arg(rendition.resolution.width)
+                      .arg(rendition.resolution.height)
+                      .arg(rendition.fps);
+      auto textSize = fontMetrics.size(0, text);
+      layerWidth    = std::max(layerWidth, textSize.width());
+      layerHeight += textSize.height();
+      texts.push_back(text);
     }
+    layerWidth += arrowTextSize.width();
 
-    auto text = QString("%1 - %2x%3@%4")
-                    .arg(rendition.name)
-                    .arg(rendition.resolution.width)
-                    .arg(rendition.resolution.height)
-                    .arg(rendition.fps);
+    auto     pixmap = this->createLayerPixmap(QSize(layerWidth, layerHeight));
+    QPainter layerPainter(&pixmap);
+    layerPainter.setFont(painter.font());
 
-    auto textSize = QFontMetrics(painter.font()).size(0, text);
+    QRect arrowTextRect;
+    arrowTextRect.setSize(arrowTextSize);
+    arrowTextRect.setLeft(0);
+
+    int topPos = 0;
+    for (auto i = int(texts.size()) - 1; i >= 0; --i)
+    {
+      layerPainter.setPen(i == currentPlaybackRendition ? Qt::green : Qt::white);
+      if (i == currentTargetRendition)
+      {
+        arrowTextRect.moveTop(topPos);
+        layerPainter.drawText(arrowTextRect, Qt::AlignLeft, arrawText);
+      }
 
-    QRect textRect;
-    textRect.setSize(textSize);
-    textRect.moveLeft(arrowTextRect.width());
-    textRect.moveTop(topPos);
+      const auto &text     = texts.at(i);
+      auto        textSize = fontMetrics.size(0, text);
 
-    painter.drawText(textRect, Qt::AlignLeft, text);
+      QRect textRect;
+      textRect.setSize(textSize);
+      textRect.moveLeft(arrowTextRect.width());
+      textRect.moveTop(topPos);
 
-    topPos += textRect.height();
+      layerPainter.drawText(textRect, Qt::AlignLeft, text);
+
+      topPos += textRect.height();
+    }
+    layerPainter.end();
+
+    this->renditionInfoLayer.pixmap = pixmap;
+    this->renditionInfoLayer.size   = QSize(layerWidth, layerHeight);
+    this->renditionInfoLayer.key    = key;
+    this->renditionInfoLayer.valid  = true;
   }
+
+  painter.drawPixmap(QPoint(0, 0), this->renditionInfoLayer.pixmap);
 }
 
 void ViewWidget::drawProgressGraph(QPainter &painter)
@@ -237,20 +455,53 @@ void ViewWidget::drawProgressGraph(QPainter &painter)
   if (!this->playbackController || !this->showProgressGraph)
     return;
 
-  QRectF graphRect(0, 0, 500, 300);
-  graphRect.moveBottomLeft(QPoint(0, this->height()));
+  auto bufferStatus = this->playbackController->getSegmentBuffer()->getBufferStatusForRender();
+  if (!bufferStatus || bufferStatus->empty())
+    return;
+
+  // The graph is scrolled so that the current frame is at the left
+  std::optional<unsigned> indexOfCurFrame;
+  const auto &            firstSegmentFrames = bufferStatus->front().frameInfo;
+  for (unsigned i = 0; i < firstSegmentFrames.size(); i++)
+  {
+    if (firstSegmentFrames.at(i).frame == this->curFrame.frame)
+      indexOfCurFrame = i;
+  }
 
-  // painter.setBrush(Qt::white);
-  // painter.drawRect(graphRect);
+  // A new snapshot is only published if the buffer changed
+  auto key = QString("%1 %2 %3 %4")
+                 .arg(quintptr(bufferStatus.get()))
+                 .arg(indexOfCurFrame ? int(*indexOfCurFrame) : -1)
+                 .arg(this->width())
+                 .arg(this->plotMaxBitrate);
+  if (this->progressGraphLayer.needsUpdate(key))
+  {
+    auto     pixmap = this->createLayerPixmap(QSize(this->width(), PROGRESS_GRAPH_HEIGHT));
+    QPainter layerPainter(&pixmap);
+    layerPainter.setFont(painter.font());
+    this->renderProgressGraph(layerPainter, *bufferStatus, indexOfCurFrame);
+    layerPainter.end();
+
+    this->progressGraphLayer.pixmap = pixmap;
+    this->progressGraphLayer.size   = QSize(this->width(), PROGRESS_GRAPH_HEIGHT);
+    this->progressGraphLayer.key    = key;
+    this->progressGraphLayer.valid  = true;
+  }
 
-  const auto colorMap = std::map<FrameState, QColor>({{FrameState::Empty, Qt::lightGray},
-                                                      {FrameState::Decoded, Qt::blue},
-                                                      {FrameState::ConvertedToRGB, Qt::green}});
+  painter.drawPixmap(QPoint(0, this->height() - PROGRESS_GRAPH_HEIGHT),
+                     this->progressGraphLayer.pixmap);
+}
 
-  auto bufferState =
-      this->playbackController->getSegmentBuffer()->getBufferStatusForRender(this->curFrame.frame);
-  if (bufferState.empty())
-    return;
+void ViewWidget::renderProgressGraph(QPainter &                          painter,
+                                     const SegmentBuffer::BufferStatus &bufferStatus,
+                                     std::optional<unsigned>            indexOfCurFrame)
+{
+  QRectF graphRect(0, 0, 500, PROGRESS_GRAPH_HEIGHT);
+
+  static const auto colorMap =
+      std::map<FrameState, QColor>({{FrameState::Empty, Qt::lightGray},
+                                    {FrameState::Decoded, Qt::blue},
+                                    {FrameState::ConvertedToRGB, Qt::green}});
 
   const auto spaceBetweenFrames   = 2.0;
   const auto spaceBetweenSegments = 1.0;
@@ -260,8 +511,8 @@ void ViewWidget::drawProgressGraph(QPainter &painter)
   frameRect.moveBottom(graphRect.bottom() - 5);
 
   auto firstSegmentLeft = 5;
-  if (auto offset = bufferState.at(0).indexOfCurFrameInFrames)
-    firstSegmentLeft -= *offset * (frameRect.width() + spaceBetweenFrames);
+  if (indexOfCurFrame)
+    firstSegmentLeft -= *indexOfCurFrame * (frameRect.width() + spaceBetweenFrames);
 
   {
     QRectF segmentRect;
@@ -271,11 +522,11 @@ void ViewWidget::drawProgressGraph(QPainter &painter)
     auto segmentLeft = firstSegmentLeft;
 
     auto firstSegmentNrFrames = SEMGENT_LENGTH_FRAMES_GUESS;
-    if (bufferState.size() > 0 && bufferState[0].nrFrames > 0)
-      firstSegmentNrFrames = bufferState[0].nrFrames;
+    if (bufferStatus.size() > 0 && bufferStatus[0].nrFrames > 0)
+      firstSegmentNrFrames = bufferStatus[0].nrFrames;
 
     painter.setPen(Qt::NoPen);
-    for (auto &segment : bufferState)
+    for (auto &segment : bufferStatus)
     {
       auto nrFrames = segment.nrFrames;
       if (nrFrames == 0)
@@ -323,7 +574,7 @@ void ViewWidget::drawProgressGraph(QPainter &painter)
       for (auto &frameInfo : segment.frameInfo)
       {
         frameRect.moveLeft(frameLeft);
-        painter.setBrush(colorMap.at(frameInfo.frameState));
+        painter.setBrush(frameInfo.dropped ? QColor(Qt::red) : colorMap.at(frameInfo.frameState));
         painter.drawRect(frameRect);
 
         auto frameBitrateRect = frameRect;
@@ -342,18 +593,21 @@ void ViewWidget::clearMessages()
 {
   std::scoped_lock lock(this->messagesMutex);
   this->messages.clear();
+  this->messagesLayer.valid = false;
   this->update();
 }
 
 void ViewWidget::setScaleVideo(bool scaleVideo)
 {
   this->scaleVideo = scaleVideo;
+  this->updateConversionTargetSize();
   this->update();
 }
 
 void ViewWidget::setShowDebugInfo(bool showDebugInfo)
 {
-  this->showDebugInfo = showDebugInfo;
+  this->showDebugInfo           = showDebugInfo;
+  this->debugInfoRenderMaxWidth = 0;
   this->update();
 }
 
@@ -366,14 +620,50 @@ void ViewWidget::setShowProgressGraph(bool showGraph)
 void ViewWidget::setPlaybackFps(double framerate)
 {
   this->targetFPS = framerate;
+  this->restartPresentation();
+}
 
-  if (framerate == 0.0)
-    timer.stop();
-  else
+void ViewWidget::setPlaybackSpeed(unsigned speed)
+{
+  this->playbackSpeed = std::max(speed, 1u);
+  this->restartPresentation();
+}
+
+void ViewWidget::showFrame(const Frame &frame)
+{
+  // The YUV data is uploaded right away. Once the frame is recycled its data is gone.
+  if (this->renderYUVWithOpenGL && this->yuvRenderer.isInitialized())
   {
-    auto timerInterval = int(1000.0 / this->targetFPS);
-    timer.start(timerInterval, Qt::PreciseTimer, this);
+    this->makeCurrent();
+    auto uploaded =
+        this->yuvRenderer.uploadFrame(frame.rawYUVData, frame.pixelFormat, frame.frameSize);
+    this->doneCurrent();
+    if (uploaded)
+    {
+      this->curImage = QImage();
+      return;
+    }
   }
+
+  // Frames that were not converted to RGB (e.g. right after switching the renderer or if the
+  // format can not be rendered with OpenGL) are converted here.
+  if (frame.rgbImage.isNull())
+    video::yuv::convertYUVToImage(
+        frame.rawYUVData, this->curImage, frame.pixelFormat, frame.frameSize);
+  else
+    this->curImage = frame.rgbImage;
+}
+
+void ViewWidget::restartPresentation()
+{
+  if (this->targetFPS == 0.0)
+    return;
+
+  this->presentationClock.setFramesPerSecond(this->targetFPS * this->playbackSpeed,
+                                             PresentationClock::Clock::now());
+
+  // The swap of this paint starts the presentation
+  this->update();
 }
 
 void ViewWidget::setPlotMaxBitrate(unsigned plotMaxBitrate)
@@ -388,12 +678,19 @@ void ViewWidget::onPlayPause()
     return;
 
   this->pause = !this->pause;
+  if (this->pause)
+    this->presentationClock.pause(PresentationClock::Clock::now());
+  else
+  {
+    this->presentationClock.resume(PresentationClock::Clock::now());
+    this->update();
+  }
 }
 
 void ViewWidget::onStep()
 {
-  if (this->pause)
-    this->getNextFrame();
+  if (this->pause && this->getNextFrame())
+    this->update();
 }
 
 void ViewWidget::timerEvent(QTimerEvent *event)
@@ -405,13 +702,72 @@ void ViewWidget::timerEvent(QTimerEvent *event)
 
   DEBUG("Timer event");
 
-  if (!this->pause)
-    this->getNextFrame();
+  // Only repaint for the overlays if something changed. The debug info and the progress graph
+  // change all the time, so these are kept up to date when nothing was painted for a while. While
+  // playing, this also restarts the presentation if no swap happened for a while (e.g. while the
+  // window was hidden).
+  this->removeExpiredMessages();
+  auto now           = PresentationClock::Clock::now();
+  auto paintOutdated = (this->showDebugInfo || this->showProgressGraph || this->isPresenting()) &&
+                       now - this->lastPaint > OVERLAY_UPDATE_INTERVAL;
+  auto newMessages   = this->messagesChanged.exchange(false);
+  if (paintOutdated || newMessages)
+    this->update();
+}
 
+bool ViewWidget::isPresenting() const
+{
+  return this->playbackController != nullptr && this->targetFPS > 0.0 && !this->pause;
+}
+
+void ViewWidget::onFrameSwapped()
+{
+  // The swap waits for the vertical blank, so the frame of the last paint is shown now
+  auto now = PresentationClock::Clock::now();
+  if (this->frameAwaitingPresentation)
+  {
+    this->presentationClock.onFramePresented(*this->frameAwaitingPresentation, now);
+    this->frameAwaitingPresentation.reset();
+  }
+
+  if (!this->isPresenting())
+    return;
+
+  // Paint on every swap (also without a new frame) to take the due frames at every refresh
+  this->presentDueFrames(now);
   this->update();
 }
 
-void ViewWidget::getNextFrame()
+void ViewWidget::presentDueFrames(PresentationClock::TimePoint now)
+{
+  auto     nrDue    = this->presentationClock.getNrFramesDue(now);
+  bool     newImage = false;
+  uint64_t imageFrameIndex{};
+
+  while (this->presentationClock.getNrFramesTaken() < nrDue)
+  {
+    auto frameIndex = this->presentationClock.getNrFramesTaken();
+    if (!this->getNextFrame())
+    {
+      this->presentationClock.onFrameUnavailable(now);
+      break;
+    }
+    if (this->curFrame.frame->dropped)
+      continue;
+
+    // The image of an earlier frame taken for the same paint is never shown
+    if (newImage)
+      this->presentationClock.onFrameDropped();
+    newImage        = true;
+    imageFrameIndex = frameIndex;
+  }
+
+  // The deviation is measured once the frame is on the screen
+  if (newImage)
+    this->frameAwaitingPresentation = imageFrameIndex;
+}
+
+bool ViewWidget::getNextFrame()
 {
   auto                         segmentBuffer = this->playbackController->getSegmentBuffer();
   SegmentBuffer::FrameIterator displayFrame;
@@ -422,11 +778,14 @@ void ViewWidget::getNextFrame()
   if (displayFrame.isNull())
   {
     DEBUG("Show next frame. No new image available.");
-    return;
+    return false;
   }
 
   DEBUG("Show next frame. Got next image");
   this->curFrame = displayFrame;
+  this->presentationClock.onFrameTaken();
+  if (!displayFrame.frame->dropped)
+    this->showFrame(*displayFrame.frame);
 
   // Update the FPS counter every 50 frames
   this->timerFPSCounter++;
@@ -448,4 +807,6 @@ void ViewWidget::getNextFrame()
   this->frameSegmentOffset++;
   if (this->frameSegmentOffset > displayFrame.segment->nrFrames)
     this->frameSegmentOffset = 0;
+
+  return true;
 }
@@ -23,22 +23,29 @@ SOFTWARE. */
 
 #pragma once
 
+#include "PresentationClock.h"
+#include "YUVRendererGL.h"
+
 #include <PlaybackController.h>
 #include <common/ILogger.h>
 
 #include <QBasicTimer>
 #include <QImage>
+#include <QOpenGLWidget>
+#include <QPixmap>
 #include <QTime>
-#include <QWidget>
+#include <atomic>
 #include <chrono>
 #include <mutex>
+#include <optional>
 
-class ViewWidget : public QWidget, public ILogger
+class ViewWidget : public QOpenGLWidget, public ILogger
 {
   Q_OBJECT;
 
 public:
   ViewWidget(QWidget *parent);
+  ~ViewWidget();
 
   void setPlaybackController(PlaybackController *playbackController);
 
@@ -47,14 +54,24 @@ public:
   void setScaleVideo(bool scaleVideo);
   void setShowDebugInfo(bool showDebugInfo);
   void setShowProgressGraph(bool drawGraph);
+  // Render the YUV frames with OpenGL instead of converting them to RGB images. If OpenGL can not
+  // be used, the software conversion is used.
+  void setRenderYUVWithOpenGL(bool renderWithOpenGL);
 
   void setPlaybackFps(double framerate);
+  // For trick play the frames are taken from the buffer this many times faster
+  void setPlaybackSpeed(unsigned speed);
   void setPlotMaxBitrate(unsigned plotMaxBitrate);
   void onPlayPause();
   void onStep();
 
 private:
-  virtual void paintEvent(QPaintEvent *event) override;
+  virtual void initializeGL() override;
+  virtual void paintGL() override;
+  virtual void resizeGL(int width, int height) override;
+
+  // With the software conversion, frames are converted directly to the size of the widget
+  void updateConversionTargetSize();
 
   struct ViewWidgetMessage
   {
@@ -64,25 +81,88 @@ private:
   };
   std::vector<ViewWidgetMessage> messages;
   std::mutex                     messagesMutex;
+  // Set from any thread if the messages changed. The GUI thread then repaints.
+  std::atomic_bool messagesChanged{false};
+  void             removeExpiredMessages();
 
-  void drawCurrentFrame(QPainter &painter);
-  void drawAndUpdateMessages(QPainter &painter);
-  void drawFPSAndStatusText(QPainter &painter);
-  void drawRenditionInfo(QPainter &painter);
-  void drawProgressGraph(QPainter &painter);
+  // The overlays are rendered into pixmaps which are only rendered again if their content
+  // changes. For every paint the cached pixmaps are drawn on top of the frame.
+  struct OverlayLayer
+  {
+    QPixmap pixmap;
+    QSize   size;
+    QString key;
+    bool    valid{};
 
+    bool needsUpdate(const QString &newKey) const { return !this->valid || this->key != newKey; }
+  };
+  OverlayLayer messagesLayer;
+  OverlayLayer statusTextLayer;
+  OverlayLayer renditionInfoLayer;
+  OverlayLayer progressGraphLayer;
+  QPixmap      createLayerPixmap(QSize size) const;
+  void         invalidateOverlays();
+
+  QRect getVideoRect(QSize frameSize) const;
+  void  drawCurrentFrame(QPainter &painter);
+  void  drawMessages(QPainter &painter);
+  void  drawFPSAndStatusText(QPainter &painter);
+  void  drawRenditionInfo(QPainter &painter);
+  void  drawProgressGraph(QPainter &painter);
+  void  renderProgressGraph(QPainter &                          painter,
+                            const SegmentBuffer::BufferStatus &bufferStatus,
+                            std::optional<unsigned>            indexOfCurFrame);
+
+  // The time spent in paintGL. Updated every PAINT_TIME_NR_PAINTS paints.
+  struct PaintTime
+  {
+    double averageMs{};
+    double maxMs{};
+    double overlaysAverageMs{};
+
+    unsigned nrPaints{};
+    double   sumMs{};
+    double   sumOverlaysMs{};
+    double   curMaxMs{};
+  };
+  PaintTime paintTime;
+  void      updatePaintTime(double paintMs, double overlaysMs);
+
+  // Keeps the messages and overlays up to date. The frames are presented on the buffer swaps.
   QBasicTimer  timer;
   int          timerFPSCounter{};
   QTime        timerLastFPSTime;
   double       targetFPS{};
+  unsigned     playbackSpeed{1};
   double       actualFPS{};
   bool         pause{false};
   virtual void timerEvent(QTimerEvent *event) override;
-
-  void getNextFrame();
+  void         restartPresentation();
+
+  /* The buffer swaps wait for the vertical blank (swap interval 1). While playing, every swap
+   * takes the frames that are due according to the presentation clock and schedules the next
+   * paint, so frames are presented in step with the display refresh. The deviation from the due
+   * time is measured when the swap that shows the frame is done.
+   */
+  PresentationClock            presentationClock;
+  PresentationClock::TimePoint lastPaint;
+  std::optional<uint64_t>      frameAwaitingPresentation;
+  bool                         isPresenting() const;
+  void                         onFrameSwapped();
+  void                         presentDueFrames(PresentationClock::TimePoint now);
+
+  // Returns false if no frame is available
+  bool getNextFrame();
 
   PlaybackController *         playbackController{};
   SegmentBuffer::FrameIterator curFrame;
+  // The image that is shown. For dropped frames the previous image is repeated.
+  QImage curImage;
+  void   showFrame(const Frame &frame);
+
+  YUVRendererGL yuvRenderer;
+  bool          renderYUVWithOpenGL{true};
+  bool          openGLFailed{false};
 
   int debugInfoRenderMaxWidth{};
 
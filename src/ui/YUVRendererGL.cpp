@@ -0,0 +1,251 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include "YUVRendererGL.h"
+
+#include <QOpenGLContext>
+
+// Not part of the OpenGL ES 2.0 headers. Only used with desktop OpenGL.
+#ifndef GL_LUMINANCE16
+#define GL_LUMINANCE16 0x8042
+#endif
+
+namespace
+{
+
+using video::yuv::ColorConversion;
+using video::yuv::PlaneOrder;
+using video::yuv::Subsampling;
+
+constexpr int VERTEX_ATTRIBUTE  = 0;
+constexpr int TEXTURE_ATTRIBUTE = 1;
+
+const char *VERTEX_SHADER = R"(
+attribute highp vec4 vertexPosition;
+attribute highp vec2 texturePosition;
+varying highp vec2 textureCoordinate;
+void main()
+{
+  gl_Position       = vertexPosition;
+  textureCoordinate = texturePosition;
+}
+)";
+
+// The coefficients are the same as in the software conversion. Because the conversion is linear,
+// they also apply to the normalized sample values.
+const char *FRAGMENT_SHADER = R"(
+uniform sampler2D textureY;
+uniform sampler2D textureU;
+uniform sampler2D textureV;
+uniform mediump float sampleScale;
+uniform mediump float lumaOffset;
+uniform mediump float lumaScale;
+uniform mediump vec4 chromaCoefficients;
+varying highp vec2 textureCoordinate;
+void main()
+{
+  mediump float y = texture2D(textureY, textureCoordinate).r * sampleScale;
+  y               = (y - lumaOffset) * lumaScale;
+  mediump float u = texture2D(textureU, textureCoordinate).r * sampleScale - 0.5;
+  mediump float v = texture2D(textureV, textureCoordinate).r * sampleScale - 0.5;
+  gl_FragColor    = vec4(y + chromaCoefficients.x * v,
+                         y + chromaCoefficients.y * u + chromaCoefficients.z * v,
+                         y + chromaCoefficients.w * u,
+                         1.0);
+}
+)";
+
+} // namespace
+
+bool YUVRendererGL::initialize(ILogger *logger)
+{
+  this->initializeOpenGLFunctions();
+  this->isOpenGLES = QOpenGLContext::currentContext()->isOpenGLES();
+
+  auto newProgram = std::make_unique<QOpenGLShaderProgram>();
+  newProgram->bindAttributeLocation("vertexPosition", VERTEX_ATTRIBUTE);
+  newProgram->bindAttributeLocation("texturePosition", TEXTURE_ATTRIBUTE);
+  if (!newProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, VERTEX_SHADER) ||
+      !newProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, FRAGMENT_SHADER) ||
+      !newProgram->link())
+  {
+    logger->addMessage("Error creating the OpenGL YUV shader: " + newProgram->log(),
+                       LoggingPriority::Warning);
+    return false;
+  }
+
+  int RGBConv[5];
+  video::yuv::getColorConversionCoefficients(ColorConversion::BT709_LimitedRange, RGBConv);
+  const auto toFloat = [](int coefficient) { return float(coefficient) / 65536.0f; };
+
+  newProgram->bind();
+  newProgram->setUniformValue("textureY", 0);
+  newProgram->setUniformValue("textureU", 1);
+  newProgram->setUniformValue("textureV", 2);
+  newProgram->setUniformValue("lumaOffset", 16.0f / 255.0f);
+  newProgram->setUniformValue("lumaScale", toFloat(RGBConv[0]));
+  newProgram->setUniformValue("chromaCoefficients",
+                              toFloat(RGBConv[1]),
+                              toFloat(RGBConv[2]),
+                              toFloat(RGBConv[3]),
+                              toFloat(RGBConv[4]));
+  newProgram->release();
+
+  this->glGenTextures(NR_PLANES, this->textures);
+  for (auto texture : this->textures)
+  {
+    this->glBindTexture(GL_TEXTURE_2D, texture);
+    this->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    this->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    this->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    this->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+  this->glBindTexture(GL_TEXTURE_2D, 0);
+
+  this->program = std::move(newProgram);
+  return true;
+}
+
+void YUVRendererGL::cleanup()
+{
+  if (!this->isInitialized())
+    return;
+
+  this->glDeleteTextures(NR_PLANES, this->textures);
+  for (int i = 0; i < NR_PLANES; i++)
+  {
+    this->textures[i]     = 0;
+    this->textureSizes[i] = {};
+  }
+  this->program.reset();
+  this->frameSize = {};
+}
+
+bool YUVRendererGL::uploadFrame(const QByteArray &                yuvData,
+                                const video::yuv::PixelFormatYUV &pixelFormat,
+                                const Size &                      frameSize)
+{
+  if (!this->isInitialized() || yuvData.isEmpty() || !frameSize.isValid())
+    return false;
+
+  const auto bitDepth = pixelFormat.getBitsPerSample();
+  if (!pixelFormat.isPlanar() || pixelFormat.isUVInterleaved() || pixelFormat.isBigEndian() ||
+      pixelFormat.getSubsampling() == Subsampling::YUV_400 || bitDepth < 8 || bitDepth > 16)
+    return false;
+  // There are no 16 bit luminance textures in OpenGL ES 2.0
+  if (bitDepth > 8 && this->isOpenGLES)
+    return false;
+  if (yuvData.size() < pixelFormat.bytesPerFrame(frameSize))
+    return false;
+
+  const auto bytesPerSample = (bitDepth > 8) ? 2u : 1u;
+  const auto chromaSize     = Size(frameSize.width / unsigned(pixelFormat.getSubsamplingHor()),
+                               frameSize.height / unsigned(pixelFormat.getSubsamplingVer()));
+  const auto lumaBytes      = frameSize.width * frameSize.height * bytesPerSample;
+  const auto chromaBytes    = chromaSize.width * chromaSize.height * bytesPerSample;
+  const bool vPlaneFirst    = (pixelFormat.getPlaneOrder() == PlaneOrder::YVU ||
+                            pixelFormat.getPlaneOrder() == PlaneOrder::YVUA);
+
+  const Size  planeSizes[NR_PLANES] = {frameSize, chromaSize, chromaSize};
+  const char *planeData[NR_PLANES]  = {yuvData.constData(),
+                                      yuvData.constData() + lumaBytes +
+                                          (vPlaneFirst ? chromaBytes : 0),
+                                      yuvData.constData() + lumaBytes +
+                                          (vPlaneFirst ? 0 : chromaBytes)};
+
+  const GLint  internalFormat = (bitDepth > 8) ? GL_LUMINANCE16 : GL_LUMINANCE;
+  const GLenum sampleType     = (bitDepth > 8) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+
+  // The chroma planes may have widths that are not a multiple of 4
+  this->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (int i = 0; i < NR_PLANES; i++)
+  {
+    const auto width  = GLsizei(planeSizes[i].width);
+    const auto height = GLsizei(planeSizes[i].height);
+    this->glBindTexture(GL_TEXTURE_2D, this->textures[i]);
+    if (this->textureSizes[i] == planeSizes[i] && this->textureBitDepth == bitDepth)
+      this->glTexSubImage2D(
+          GL_TEXTURE_2D, 0, 0, 0, width, height, GL_LUMINANCE, sampleType, planeData[i]);
+    else
+      this->glTexImage2D(GL_TEXTURE_2D,
+                         0,
+                         internalFormat,
+                         width,
+                         height,
+                         0,
+                         GL_LUMINANCE,
+                         sampleType,
+                         planeData[i]);
+    this->textureSizes[i] = planeSizes[i];
+  }
+  this->glBindTexture(GL_TEXTURE_2D, 0);
+  this->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  // 16 bit textures are normalized to 65535. Scale the samples so that the maximum of the bit
+  // depth is 1.0.
+  this->textureBitDepth = bitDepth;
+  this->sampleScale     = (bitDepth > 8) ? 65535.0f / float((1u << bitDepth) - 1) : 1.0f;
+  this->frameSize       = frameSize;
+  return true;
+}
+
+void YUVRendererGL::draw(const QRect &targetRect, const QSize &viewportSize)
+{
+  if (!this->isInitialized() || !this->hasFrame())
+    return;
+
+  static const GLfloat vertexPositions[]  = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+  static const GLfloat texturePositions[] = {0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+
+  // OpenGL counts from the bottom of the viewport
+  this->glViewport(targetRect.x(),
+                   viewportSize.height() - targetRect.y() - targetRect.height(),
+                   targetRect.width(),
+                   targetRect.height());
+  this->glDisable(GL_BLEND);
+
+  this->program->bind();
+  this->program->setUniformValue("sampleScale", this->sampleScale);
+  for (int i = 0; i < NR_PLANES; i++)
+  {
+    this->glActiveTexture(GL_TEXTURE0 + i);
+    this->glBindTexture(GL_TEXTURE_2D, this->textures[i]);
+  }
+
+  this->program->enableAttributeArray(VERTEX_ATTRIBUTE);
+  this->program->enableAttributeArray(TEXTURE_ATTRIBUTE);
+  this->program->setAttributeArray(VERTEX_ATTRIBUTE, vertexPositions, 2);
+  this->program->setAttributeArray(TEXTURE_ATTRIBUTE, texturePositions, 2);
+
+  this->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  this->program->disableAttributeArray(VERTEX_ATTRIBUTE);
+  this->program->disableAttributeArray(TEXTURE_ATTRIBUTE);
+  this->program->release();
+
+  for (int i = NR_PLANES - 1; i >= 0; i--)
+  {
+    this->glActiveTexture(GL_TEXTURE0 + i);
+    this->glBindTexture(GL_TEXTURE_2D, 0);
+  }
+}
@@ -0,0 +1,76 @@
+/* MIT License
+
+Copyright (c) 2021 Christian Feldmann <christian.feldmann@gmx.de>
+                                      <christian.feldmann@bitmovin.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#pragma once
+
+#include <common/ILogger.h>
+#include <common/Typedef.h>
+#include <video/PixelFormatYUV.h>
+
+#include <QByteArray>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QRect>
+#include <memory>
+
+/* Renders YUV frames with OpenGL.
+ *
+ * The Y, U and V planes of a frame are uploaded as single channel textures. The texture units do
+ * the chroma upsampling and the scaling to the output size, and a fragment shader converts to RGB
+ * with the same coefficients as the software conversion. Only what OpenGL 2.0 / OpenGL ES 2.0
+ * offers is used, so this also runs on software implementations like Mesa llvmpipe.
+ *
+ * All functions must be called with the OpenGL context current.
+ */
+class YUVRendererGL : protected QOpenGLFunctions
+{
+public:
+  YUVRendererGL() = default;
+
+  // Returns false if the shaders can not be used. The renderer can not be used then.
+  bool initialize(ILogger *logger);
+  void cleanup();
+  bool isInitialized() const { return this->program != nullptr; }
+
+  // Upload the planes of a frame into the textures. Returns false if the format is not supported.
+  bool uploadFrame(const QByteArray &                yuvData,
+                   const video::yuv::PixelFormatYUV &pixelFormat,
+                   const Size &                      frameSize);
+  bool hasFrame() const { return this->frameSize.isValid(); }
+  Size getFrameSize() const { return this->frameSize; }
+
+  // Draw the uploaded frame into targetRect. Both are in device pixels.
+  void draw(const QRect &targetRect, const QSize &viewportSize);
+
+private:
+  std::unique_ptr<QOpenGLShaderProgram> program;
+
+  static constexpr int NR_PLANES = 3;
+  GLuint               textures[NR_PLANES]{};
+  Size                 textureSizes[NR_PLANES]{};
+  unsigned             textureBitDepth{};
+
+  Size  frameSize{};
+  float sampleScale{1.0f};
+  bool  isOpenGLES{};
+};
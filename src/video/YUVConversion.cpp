@@ -23,7 +23,9 @@ SOFTWARE. */
 
 #include "YUVConversion.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <vector>
 
 // Restrict is basically a promise to the compiler that for the scope of the pointer, the target of
 // the pointer will only be accessed through that pointer (and pointers copied from it).
@@ -644,15 +646,15 @@ bool convertYUV420ToRGB(const QByteArray &   sourceBuffer,
   return true;
 }
 
-bool convertYUVPlanarToRGB(const QByteArray &    sourceBuffer,
-                           uchar *               targetBuffer,
-                           const Size            curFrameSize,
-                           const PixelFormatYUV &sourceBufferFormat)
+bool convertYUVPlanarToRGB(const QByteArray &        sourceBuffer,
+                           uchar *                   targetBuffer,
+                           const Size                curFrameSize,
+                           const PixelFormatYUV &    sourceBufferFormat,
+                           const ChromaInterpolation interpolation)
 {
   // These are constant for the runtime of this function. This way, the compiler can optimize the
   // hell out of this function.
   const auto format        = sourceBufferFormat;
-  const auto interpolation = ChromaInterpolation::NearestNeighbor;
   const auto conversion    = ColorConversion::BT709_LimitedRange;
   const auto w             = curFrameSize.width;
   const auto h             = curFrameSize.height;
@@ -753,30 +755,123 @@ bool convertYUVPlanarToRGB(const QByteArray &    sourceBuffer,
   return true;
 }
 
-} // namespace
+// For every output position the two neighboring source positions and the weight (0...256) of the
+// second one. The sample centers of the source and output are aligned.
+struct InterpolationTap
+{
+  unsigned index0;
+  unsigned index1;
+  unsigned weight1;
+};
 
-namespace video::yuv
+std::vector<InterpolationTap> getInterpolationTaps(unsigned sourceLength, unsigned outputLength)
 {
+  std::vector<InterpolationTap> taps(outputLength);
+  for (unsigned i = 0; i < outputLength; i++)
+  {
+    auto position = (int64_t(2 * i + 1) * sourceLength * 256 / (2 * outputLength)) - 128;
+    if (position < 0)
+      position = 0;
+    auto index0     = unsigned(position >> 8);
+    taps[i].index0  = std::min(index0, sourceLength - 1);
+    taps[i].index1  = std::min(index0 + 1, sourceLength - 1);
+    taps[i].weight1 = unsigned(position & 0xff);
+  }
+  return taps;
+}
 
-// Convert the given raw YUV data in sourceBuffer (using srcPixelFormat) to image (RGB-888), using
-// the buffer tmpRGBBuffer for intermediate RGB values.
-void convertYUVToImage(const QByteArray &    sourceBuffer,
-                       QImage &              outputImage,
-                       const PixelFormatYUV &yuvFormat,
-                       const Size &          curFrameSize)
+template <typename InValueType>
+inline unsigned interpolateBilinear(const InValueType *restrict row0,
+                                    const InValueType *restrict row1,
+                                    const InterpolationTap &    tapX,
+                                    const unsigned              weightY1)
 {
-  if (!yuvFormat.canConvertToRGB(curFrameSize) || sourceBuffer.isEmpty())
+  // With 16 bit input, the result still fits into 32 bit
+  const unsigned weightX0 = 256 - tapX.weight1;
+  const unsigned top      = row0[tapX.index0] * weightX0 + row0[tapX.index1] * tapX.weight1;
+  const unsigned bottom   = row1[tapX.index0] * weightX0 + row1[tapX.index1] * tapX.weight1;
+  return (top * (256 - weightY1) + bottom * weightY1 + 32768) >> 16;
+}
+
+// Convert planar YUV to RGB at a different output size. The chroma upsampling and the scaling are
+// one bilinear interpolation per component, so only the output samples are ever converted.
+template <typename InValueType>
+bool convertYUVPlanarToRGBScaled(const QByteArray &    sourceBuffer,
+                                 unsigned char *       targetBuffer,
+                                 const Size            frameSize,
+                                 const Size            outputSize,
+                                 const PixelFormatYUV &format)
+{
+  const auto chromaSize = Size(frameSize.width / unsigned(format.getSubsamplingHor()),
+                               frameSize.height / unsigned(format.getSubsamplingVer()));
+  const auto lumaTapsX   = getInterpolationTaps(frameSize.width, outputSize.width);
+  const auto lumaTapsY   = getInterpolationTaps(frameSize.height, outputSize.height);
+  const auto chromaTapsX = getInterpolationTaps(chromaSize.width, outputSize.width);
+  const auto chromaTapsY = getInterpolationTaps(chromaSize.height, outputSize.height);
+
+  // The conversion is done with 8 bit values like in the other functions
+  const auto rightShift = int(format.getBitsPerSample()) - 8;
+  const int  yOffset    = 16;
+  const int  cZero      = 128;
+  int        RGBConv[5];
+  getColorConversionCoefficients(ColorConversion::BT709_LimitedRange, RGBConv);
+
+  static unsigned char *clip_buf = clp_buf + 384;
+  if (!clp_buf_initialized)
+    initClippingTable();
+
+  const bool uPlaneFirst =
+      (format.getPlaneOrder() == PlaneOrder::YUV || format.getPlaneOrder() == PlaneOrder::YUVA);
+  const auto *restrict srcY = (const InValueType *)sourceBuffer.constData();
+  const auto *restrict srcC0 = srcY + frameSize.width * frameSize.height;
+  const auto *restrict srcC1 = srcC0 + chromaSize.width * chromaSize.height;
+  const auto *restrict srcU  = uPlaneFirst ? srcC0 : srcC1;
+  const auto *restrict srcV  = uPlaneFirst ? srcC1 : srcC0;
+
+  unsigned char *restrict dst = targetBuffer;
+  for (unsigned y = 0; y < outputSize.height; y++)
   {
-    outputImage = QImage();
-    return;
+    const auto &lumaTapY   = lumaTapsY[y];
+    const auto &chromaTapY = chromaTapsY[y];
+    const auto *rowY0      = srcY + lumaTapY.index0 * frameSize.width;
+    const auto *rowY1      = srcY + lumaTapY.index1 * frameSize.width;
+    const auto *rowU0      = srcU + chromaTapY.index0 * chromaSize.width;
+    const auto *rowU1      = srcU + chromaTapY.index1 * chromaSize.width;
+    const auto *rowV0      = srcV + chromaTapY.index0 * chromaSize.width;
+    const auto *rowV1      = srcV + chromaTapY.index1 * chromaSize.width;
+
+    for (unsigned x = 0; x < outputSize.width; x++)
+    {
+      const int valY =
+          int(interpolateBilinear(rowY0, rowY1, lumaTapsX[x], lumaTapY.weight1) >> rightShift);
+      const int valU =
+          int(interpolateBilinear(rowU0, rowU1, chromaTapsX[x], chromaTapY.weight1) >> rightShift);
+      const int valV =
+          int(interpolateBilinear(rowV0, rowV1, chromaTapsX[x], chromaTapY.weight1) >> rightShift);
+
+      const int Y_tmp = (valY - yOffset) * RGBConv[0];
+      const int U_tmp = valU - cZero;
+      const int V_tmp = valV - cZero;
+
+      dst[0] = clip_buf[(Y_tmp + U_tmp * RGBConv[4]) >> 16];
+      dst[1] = clip_buf[(Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> 16];
+      dst[2] = clip_buf[(Y_tmp + V_tmp * RGBConv[1]) >> 16];
+      dst[3] = 255;
+      dst += 4;
+    }
   }
 
+  return true;
+}
+
+void allocateOutputImage(QImage &outputImage, const Size &size)
+{
   // Create the output image in the right format.
   // In both cases, we will set the alpha channel to 255. The format of the raw buffer is: BGRA
   // (each 8 bit). Internally, this is how QImage allocates the number of bytes per line (with depth
   // = 32): const int bytes_per_line = ((width * depth + 31) >> 5) << 2; // bytes per scanline (must
   // be multiple of 4)
-  auto qFrameSize = QSize(int(curFrameSize.width), int(curFrameSize.height));
+  auto qFrameSize = QSize(int(size.width), int(size.height));
   if (is_Q_OS_WIN || is_Q_OS_MAC)
     outputImage = QImage(qFrameSize, platformImageFormat());
   else if (is_Q_OS_LINUX)
@@ -790,15 +885,49 @@ void convertYUVToImage(const QByteArray &    sourceBuffer,
 
   // Check the image buffer size before we write to it
 #if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
-  assert(clipToUnsigned(outputImage.byteCount()) >= curFrameSize.width * curFrameSize.height * 4);
+  assert(clipToUnsigned(outputImage.byteCount()) >= size.width * size.height * 4);
 #else
-  assert(clipToUnsigned(outputImage.sizeInBytes()) >= curFrameSize.width * curFrameSize.height * 4);
+  assert(clipToUnsigned(outputImage.sizeInBytes()) >= size.width * size.height * 4);
 #endif
+}
+
+void convertToPlatformImageFormat(QImage &outputImage)
+{
+  if (is_Q_OS_LINUX)
+  {
+    // On linux, we may have to convert the image to the platform image format if it is not one of
+    // the RGBA formats.
+    QImage::Format f = platformImageFormat();
+    if (f != QImage::Format_ARGB32_Premultiplied && f != QImage::Format_ARGB32 &&
+        f != QImage::Format_RGB32)
+      outputImage = outputImage.convertToFormat(f);
+  }
+}
+
+} // namespace
+
+namespace video::yuv
+{
+
+// Convert the given raw YUV data in sourceBuffer (using srcPixelFormat) to image (RGB-888), using
+// the buffer tmpRGBBuffer for intermediate RGB values.
+void convertYUVToImage(const QByteArray &    sourceBuffer,
+                       QImage &              outputImage,
+                       const PixelFormatYUV &yuvFormat,
+                       const Size &          curFrameSize,
+                       ChromaInterpolation   chromaInterpolation)
+{
+  if (!yuvFormat.canConvertToRGB(curFrameSize) || sourceBuffer.isEmpty())
+  {
+    outputImage = QImage();
+    return;
+  }
+
+  allocateOutputImage(outputImage, curFrameSize);
 
   bool convOK;
 
   // Convert the source to RGB
-  const auto chromaInterpolation = ChromaInterpolation::NearestNeighbor;
   if (yuvFormat.isPlanar())
   {
     if ((yuvFormat.getBitsPerSample() == 8 || yuvFormat.getBitsPerSample() == 10) &&
@@ -816,7 +945,8 @@ void convertYUVToImage(const QByteArray &    sourceBuffer,
     }
 
     else
-      convOK = convertYUVPlanarToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
+      convOK = convertYUVPlanarToRGB(
+          sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat, chromaInterpolation);
   }
   else
   {
@@ -825,15 +955,55 @@ void convertYUVToImage(const QByteArray &    sourceBuffer,
 
   assert(convOK);
 
-  if (is_Q_OS_LINUX)
+  convertToPlatformImageFormat(outputImage);
+}
+
+void convertYUVToImage(const QByteArray &    sourceBuffer,
+                       QImage &              outputImage,
+                       const PixelFormatYUV &yuvFormat,
+                       const Size &          curFrameSize,
+                       const Size &          outputSize)
+{
+  if (outputSize == curFrameSize || !outputSize.isValid())
   {
-    // On linux, we may have to convert the image to the platform image format if it is not one of
-    // the RGBA formats.
-    QImage::Format f = platformImageFormat();
-    if (f != QImage::Format_ARGB32_Premultiplied && f != QImage::Format_ARGB32 &&
-        f != QImage::Format_RGB32)
-      outputImage = outputImage.convertToFormat(f);
+    convertYUVToImage(sourceBuffer, outputImage, yuvFormat, curFrameSize);
+    return;
+  }
+
+  if (!yuvFormat.canConvertToRGB(curFrameSize) || sourceBuffer.isEmpty())
+  {
+    outputImage = QImage();
+    return;
   }
+
+  const auto bitsPerSample = yuvFormat.getBitsPerSample();
+  const bool scaledConversionSupported =
+      yuvFormat.isPlanar() && !yuvFormat.isUVInterleaved() && !yuvFormat.isBigEndian() &&
+      yuvFormat.getSubsampling() != Subsampling::YUV_400 && bitsPerSample >= 8 &&
+      bitsPerSample <= 16 && sourceBuffer.size() >= yuvFormat.bytesPerFrame(curFrameSize);
+  if (!scaledConversionSupported)
+  {
+    // Convert in full resolution and scale the image
+    convertYUVToImage(sourceBuffer, outputImage, yuvFormat, curFrameSize);
+    outputImage = outputImage.scaled(QSize(int(outputSize.width), int(outputSize.height)),
+                                     Qt::IgnoreAspectRatio,
+                                     Qt::SmoothTransformation);
+    return;
+  }
+
+  allocateOutputImage(outputImage, outputSize);
+
+  bool convOK;
+  if (bitsPerSample == 8)
+    convOK = convertYUVPlanarToRGBScaled<uint8_t>(
+        sourceBuffer, outputImage.bits(), curFrameSize, outputSize, yuvFormat);
+  else
+    convOK = convertYUVPlanarToRGBScaled<uint16_t>(
+        sourceBuffer, outputImage.bits(), curFrameSize, outputSize, yuvFormat);
+
+  assert(convOK);
+
+  convertToPlatformImageFormat(outputImage);
 }
 
 } // namespace video::yuv
@@ -31,10 +31,21 @@ SOFTWARE. */
 namespace video::yuv
 {
 
-// Convert from YUV (which ever format is selected) to image (RGB-888)
+// Convert from YUV (which ever format is selected) to image (RGB-888). The chroma interpolation
+// is used for the upsampling of 4:2:0 and 4:2:2 chroma.
 void convertYUVToImage(const QByteArray &                sourceBuffer,
                        QImage &                          outputImage,
                        const video::yuv::PixelFormatYUV &yuvFormat,
-                       const Size &                      curFrameSize);
+                       const Size &                      curFrameSize,
+                       ChromaInterpolation               chromaInterpolation =
+                           ChromaInterpolation::NearestNeighbor);
+
+// Convert to an image of outputSize. Chroma upsampling and scaling are fused into one bilinear
+// interpolation so that only the samples of the output are converted.
+void convertYUVToImage(const QByteArray &                sourceBuffer,
+                       QImage &                          outputImage,
+                       const video::yuv::PixelFormatYUV &yuvFormat,
+                       const Size &                      curFrameSize,
+                       const Size &                      outputSize);
 
 }
@@ -10,3 +10,10 @@ HEADERS += $$files(src/*.h, true)
 FORMS += $$files(ui/*.ui, false)
 
 INCLUDEPATH += src/
+
+# Count the allocations in the parser benchmark (--benchmark-parser). This replaces the global
+# operator new and delete of the whole application, so it is only enabled with
+# qmake CONFIG+=count_allocations
+count_allocations {
+    DEFINES += COUNT_ALLOCATIONS
+}